@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * @file tetris_analytics.c
+ * @brief Source File with Player Analytics of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_analytics.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tetris_board.h"
+
+static pthread_once_t finesseOnce = PTHREAD_ONCE_INIT;
+
+// Minimal inputs + 1 by figure type, shape and column, 0 if not reachable
+static unsigned char finesse[FIGURES_COUNT][ROTATIONS_COUNT][FIELD_WIDTH];
+
+void initializeFinesse(void) {
+  Board_t board;
+  resetBoard(&board);
+
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Placement_t queue[ROTATIONS_COUNT * FIELD_WIDTH];
+    unsigned char inputs[ROTATIONS_COUNT * FIELD_WIDTH];
+    uint16_t visited[ROTATIONS_COUNT] = {0};
+    int head = 0;
+    int tail = 0;
+    Figure_t figure;
+
+    spawnBoardFigure(&board, type, &figure);
+    queue[tail] = (Placement_t){(unsigned char)figure.x,
+                                (unsigned char)figure.y,
+                                (unsigned char)figure.rotation};
+    inputs[tail++] = 1;
+    visited[figure.rotation] |= (uint16_t)(1u << figure.x);
+
+    // States are visited by number of inputs, so the first state of shape
+    // and column has the fewest ones
+    while (head < tail) {
+      Placement_t state = queue[head];
+      unsigned char count = inputs[head++];
+      const Piece_t *piece = getPiece(type, state.rotation);
+      unsigned char *cell = &finesse[type][piece->shape][state.x + piece->left];
+      if (!*cell) *cell = count;
+
+      Placement_t next[3] = {
+          {(unsigned char)(state.x - 1), state.y, state.rotation},
+          {(unsigned char)(state.x + 1), state.y, state.rotation},
+          {state.x, state.y,
+           (unsigned char)((state.rotation + 1) % ROTATIONS_COUNT)}};
+
+      for (int i = 0; i < 3; ++i) {
+        if (next[i].x < FIELD_WIDTH &&
+            !(visited[next[i].rotation] & (1u << next[i].x)) &&
+            !isPieceCollide(&board, getPiece(type, next[i].rotation),
+                            next[i].x, next[i].y)) {
+          visited[next[i].rotation] |= (uint16_t)(1u << next[i].x);
+          queue[tail] = next[i];
+          inputs[tail++] = (unsigned char)(count + 1);
+        }
+      }
+    }
+  }
+}
+
+int getMinimalInputs(int type, int rotation, int x) {
+  int inputs = -1;
+
+  if (type >= 0 && type < FIGURES_COUNT && rotation >= 0 &&
+      rotation < ROTATIONS_COUNT) {
+    const Piece_t *piece = getPiece(type, rotation);
+    int column = x + piece->left;
+
+    if (column >= 0 && column < FIELD_WIDTH) {
+      inputs = finesse[type][piece->shape][column] - 1;
+    }
+  }
+
+  return inputs;
+}
+
+void resetAnalytics(Analytics_t *analytics) {
+  pthread_once(&finesseOnce, initializeFinesse);
+  memset(analytics, 0, sizeof(*analytics));
+}
+
+void countAnalyticsAction(Analytics_t *analytics, bool isInput) {
+  analytics->actions++;
+  if (isInput) analytics->inputs++;
+}
+
+void countAnalyticsTicks(Analytics_t *analytics, unsigned long ticks) {
+  analytics->ticks += ticks;
+}
+
+void countAnalyticsPiece(Analytics_t *analytics, int type, int rotation, int x,
+                         int y, int rows) {
+  analytics->pieces++;
+  if (rows > 0 && rows <= ANALYTICS_CLEARS) analytics->clears[rows - 1]++;
+
+  // Placements without path at spawn row, e.g. tucks, are not judged
+  int minimalInputs = getMinimalInputs(type, rotation, x);
+  if (minimalInputs >= 0 && analytics->inputs > (unsigned long)minimalInputs) {
+    analytics->faults++;
+  }
+  analytics->inputs = 0;
+
+  if (type >= 0 && type < FIGURES_COUNT && rotation >= 0 &&
+      rotation < ROTATIONS_COUNT) {
+    int height =
+        FIELD_HEIGHT - BORDER_SIZE - (y + getPiece(type, rotation)->top);
+    if (height > analytics->maxHeight) analytics->maxHeight = height;
+  }
+}
+
+double getAnalyticsPps(const Analytics_t *analytics) {
+  return analytics->ticks > 0
+             ? (double)analytics->pieces * TICK_RATE / analytics->ticks
+             : 0.0;
+}
+
+double getAnalyticsApm(const Analytics_t *analytics) {
+  return analytics->ticks > 0
+             ? (double)analytics->actions * TICK_RATE * 60 / analytics->ticks
+             : 0.0;
+}
+
+int formatAnalytics(const Analytics_t *analytics, int score, bool isOver,
+                    char *text, size_t size) {
+  int length = snprintf(
+      text, size,
+      "{\"score\":%d,\"over\":%s,\"seconds\":%.3f,\"pieces\":%lu,"
+      "\"actions\":%lu,\"pps\":%.3f,\"apm\":%.1f,\"faults\":%lu,"
+      "\"clears\":[%lu,%lu,%lu,%lu],\"max_height\":%d}\n",
+      score, isOver ? "true" : "false", (double)analytics->ticks / TICK_RATE,
+      analytics->pieces, analytics->actions, getAnalyticsPps(analytics),
+      getAnalyticsApm(analytics), analytics->faults, analytics->clears[0],
+      analytics->clears[1], analytics->clears[2], analytics->clears[3],
+      analytics->maxHeight);
+
+  return length >= 0 && (size_t)length < size ? length : -1;
+}
@@ -0,0 +1,139 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+/*****************************************************************************
+ * @file tetris_analytics.h
+ * @brief Header File with Player Analytics of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ANALYTICS_PATH "./tetris.games"
+#define ANALYTICS_CLEARS 4
+#define ANALYTICS_TEXT_SIZE 256
+
+/*****************************************************************************
+ * @brief Player analytics struct
+ *
+ * Updated by game logic with O(1) work per action and per attached figure
+ *
+ * @param pieces Number of attached figures
+ * @param actions Number of moves, rotations and drops
+ * @param inputs Number of moves and rotations of current figure
+ * @param faults Number of figures placed with more inputs than minimal path
+ *from spawn position on empty board
+ * @param clears Number of attaches removing 1, 2, 3 and 4 rows
+ * @param maxHeight The highest stack height in rows
+ * @param ticks Logic ticks of game not paused
+ *****************************************************************************/
+typedef struct {
+  unsigned long pieces;
+  unsigned long actions;
+  unsigned long inputs;
+  unsigned long faults;
+  unsigned long clears[ANALYTICS_CLEARS];
+  int maxHeight;
+  unsigned long ticks;
+} Analytics_t;
+
+/*****************************************************************************
+ * @brief Initialize finesse table
+ *
+ * Search moves and rotations from spawn position at spawn row of empty board
+ *for every figure. Called once by resetAnalytics
+ *****************************************************************************/
+void initializeFinesse(void);
+
+/*****************************************************************************
+ * @brief Get minimal inputs
+ *
+ * Number of moves and rotations from spawn position to placement on empty
+ *board, made at spawn row, hard drop is not counted
+ *
+ * @param type Type of figure
+ * @param rotation Rotation of placement
+ * @param x X coordinate of placement
+ * @return int Number of inputs or -1 if placement isn't reachable at spawn
+ *row, type or rotation is out of range or table isn't initialized
+ *****************************************************************************/
+int getMinimalInputs(int type, int rotation, int x);
+
+/*****************************************************************************
+ * @brief Reset analytics
+ *
+ * Initialize finesse table on the first call
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ *****************************************************************************/
+void resetAnalytics(Analytics_t *analytics);
+
+/*****************************************************************************
+ * @brief Count action
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @param isInput Flag that action is move or rotation counted for finesse
+ *****************************************************************************/
+void countAnalyticsAction(Analytics_t *analytics, bool isInput);
+
+/*****************************************************************************
+ * @brief Count ticks of game
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @param ticks Logic ticks passed while game was not paused
+ *****************************************************************************/
+void countAnalyticsTicks(Analytics_t *analytics, unsigned long ticks);
+
+/*****************************************************************************
+ * @brief Count attached figure
+ *
+ * Count clear, compare inputs of figure with minimal ones and update stack
+ *height by the top of figure before rows are removed. Type or rotation out of
+ *range is counted as piece and clear only
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @param type Type of figure
+ * @param rotation Rotation of figure
+ * @param x X coordinate of figure center
+ * @param y Y coordinate of figure center
+ * @param rows Number of removed rows
+ *****************************************************************************/
+void countAnalyticsPiece(Analytics_t *analytics, int type, int rotation, int x,
+                         int y, int rows);
+
+/*****************************************************************************
+ * @brief Get pieces per second
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @return double Pieces per second of game not paused
+ *****************************************************************************/
+double getAnalyticsPps(const Analytics_t *analytics);
+
+/*****************************************************************************
+ * @brief Get actions per minute
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @return double Actions per minute of game not paused
+ *****************************************************************************/
+double getAnalyticsApm(const Analytics_t *analytics);
+
+/*****************************************************************************
+ * @brief Format game summary
+ *
+ * Write summary of game as one JSON line
+ *
+ * @param analytics Pointer to struct of Analytics_t
+ * @param score Score of game
+ * @param isOver Flag that game is over, not terminated
+ * @param text Buffer to write to
+ * @param size Size of buffer
+ * @return int Length of line or -1 if it doesn't fit
+ *****************************************************************************/
+int formatAnalytics(const Analytics_t *analytics, int score, bool isOver,
+                    char *text, size_t size);
+
+#endif  // ANALYTICS_H
@@ -0,0 +1,271 @@
+/*****************************************************************************
+ * @file tetris_beam.c
+ * @brief Source File with Beam Search over Queue of Upcoming Figures
+ *****************************************************************************/
+
+#include "tetris_beam.h"
+
+#include <string.h>
+#include <unistd.h>
+
+static long long getBeamTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static const int noLines[PLACEMENTS_MAX];
+
+static bool isBetterNode(const BeamNode_t *node, const BeamNode_t *other) {
+  bool isBetter = node->score > other->score;
+
+  if (node->score == other->score) {
+    isBetter = node->hash != other->hash
+                   ? node->hash < other->hash
+                   : memcmp(&node->first, &other->first,
+                            sizeof(node->first)) < 0;
+  }
+
+  return isBetter;
+}
+
+static bool isSameBoard(const BeamNode_t *node, const BeamNode_t *other) {
+  return node->hash == other->hash &&
+         memcmp(&node->board, &other->board, sizeof(node->board)) == 0;
+}
+
+void initializeBeam(Beam_t *beam, int width, int threadsCount) {
+  if (width < 1) width = 1;
+  if (width > BEAM_WIDTH_MAX) width = BEAM_WIDTH_MAX;
+  if (threadsCount < 1) threadsCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threadsCount < 1) threadsCount = 1;
+  if (threadsCount > BEAM_THREADS_MAX) threadsCount = BEAM_THREADS_MAX;
+
+  beam->width = width;
+  beam->count = 0;
+  beam->table = NULL;
+  beam->threadsCount = threadsCount;
+  beam->generation = 0;
+  beam->pending = 0;
+  beam->isActive = true;
+  pthread_mutex_init(&beam->mutex, NULL);
+  pthread_cond_init(&beam->start, NULL);
+  pthread_cond_init(&beam->done, NULL);
+
+  for (int i = 0; i < threadsCount; ++i) {
+    BeamWorker_t *worker = &beam->workers[i];
+    worker->index = i;
+    worker->beam = beam;
+    worker->count = 0;
+    worker->scratch = malloc(sizeof(BeamScratch_t));
+
+    if (NULL == worker->scratch) {
+      printf("\nNot enough memory...\n");
+      exit(1);
+    }
+
+    if (i > 0 &&
+        pthread_create(&worker->thread, NULL, runBeamWorker, worker) != 0) {
+      printf("\nUnable to start beam search...\n");
+      exit(1);
+    }
+  }
+}
+
+int searchBeam(Beam_t *beam, const Board_t *board, const Figure_t *figure,
+               const int *types, int typesCount, const Weights_t *weights,
+               long long deadline, Placement_t *placement) {
+  BeamNode_t nodes[BEAM_WIDTH_MAX];
+  int depths = 0;
+
+  beam->figure = *figure;
+  beam->weights = weights;
+  beam->deadline = deadline;
+  beam->nodes[0].board = *board;
+  beam->nodes[0].hash = getBoardHash(board);
+  beam->nodes[0].score = 0;
+  beam->nodes[0].lines = 0;
+  beam->nodes[0].first = (Placement_t){0, 0, 0};
+  beam->count = 1;
+
+  for (int depth = 0; depth <= typesCount && depths == depth; ++depth) {
+    beam->depth = depth;
+    beam->type = depth > 0 ? types[depth - 1] : figure->type;
+
+    pthread_mutex_lock(&beam->mutex);
+    beam->generation++;
+    beam->pending = beam->threadsCount - 1;
+    pthread_cond_broadcast(&beam->start);
+    pthread_mutex_unlock(&beam->mutex);
+
+    expandBeam(beam, &beam->workers[0]);
+
+    pthread_mutex_lock(&beam->mutex);
+    while (beam->pending > 0) pthread_cond_wait(&beam->done, &beam->mutex);
+    pthread_mutex_unlock(&beam->mutex);
+
+    // Merge the best children of workers, incomplete depth is dropped
+    int count = 0;
+    bool isTimeout = false;
+    for (int i = 0; i < beam->threadsCount; ++i) {
+      BeamWorker_t *worker = &beam->workers[i];
+      isTimeout = isTimeout || worker->isTimeout;
+
+      for (int j = 0; j < worker->count; ++j) {
+        insertBeamNode(nodes, &count, beam->width, &worker->nodes[j]);
+      }
+    }
+
+    if (count > 0 && !isTimeout) {
+      memcpy(beam->nodes, nodes, sizeof(nodes[0]) * (size_t)count);
+      beam->count = count;
+      *placement = nodes[0].first;
+      ++depths;
+    }
+  }
+
+  return depths;
+}
+
+void expandBeam(Beam_t *beam, BeamWorker_t *worker) {
+  BeamScratch_t *scratch = worker->scratch;
+  worker->count = 0;
+  worker->isTimeout = false;
+
+  for (int i = worker->index; i < beam->count && !worker->isTimeout;
+       i += beam->threadsCount) {
+    const BeamNode_t *node = &beam->nodes[i];
+    Figure_t figure = beam->figure;
+
+    // Depth 0 is always expanded to have a placement at all
+    worker->isTimeout = beam->depth > 0 && getBeamTime() >= beam->deadline;
+
+    if (!worker->isTimeout &&
+        (beam->depth == 0 ||
+         spawnBoardFigure(&node->board, beam->type, &figure))) {
+      int count = generatePlacements(&node->board, &figure,
+                                     scratch->placements);
+
+      for (int j = 0; j < count; ++j) {
+        const Placement_t *placement = &scratch->placements[j];
+        const Piece_t *piece = getPiece(beam->type, placement->rotation);
+        scratch->boards[j] = node->board;
+        int lines = placePiece(&scratch->boards[j], piece, placement->x,
+                               placement->y);
+
+        scratch->lines[j] = node->lines + lines;
+        // Removed rows shift the board, its hash is computed again
+        scratch->hashes[j] =
+            lines ? getBoardHash(&scratch->boards[j])
+                  : node->hash ^
+                        getPieceHash(piece, placement->x, placement->y);
+      }
+
+      scoreBeamChildren(beam, scratch, count);
+
+      for (int j = 0; j < count; ++j) {
+        BeamNode_t child = {
+            scratch->boards[j], scratch->hashes[j],
+            scratch->scores[j] +
+                beam->weights->values[FEATURE_LINES] * scratch->lines[j],
+            scratch->lines[j],
+            beam->depth > 0 ? node->first : scratch->placements[j]};
+        insertBeamNode(worker->nodes, &worker->count, beam->width, &child);
+      }
+    }
+  }
+}
+
+void scoreBeamChildren(Beam_t *beam, BeamScratch_t *scratch, int count) {
+  if (!beam->table) {
+    evaluateBoards(scratch->boards, noLines, count, beam->weights,
+                   scratch->scores);
+  } else {
+    int missed = 0;
+
+    for (int j = 0; j < count; ++j) {
+      uint64_t data;
+
+      if (probeHash(beam->table, scratch->hashes[j], &data)) {
+        uint32_t bits = (uint32_t)data;
+        memcpy(&scratch->scores[j], &bits, sizeof(bits));
+      } else {
+        scratch->missed[missed] = j;
+        scratch->missedBoards[missed++] = scratch->boards[j];
+      }
+    }
+
+    evaluateBoards(scratch->missedBoards, noLines, missed, beam->weights,
+                   scratch->missedScores);
+
+    for (int m = 0; m < missed; ++m) {
+      int j = scratch->missed[m];
+      uint32_t bits;
+      memcpy(&bits, &scratch->missedScores[m], sizeof(bits));
+      scratch->scores[j] = scratch->missedScores[m];
+      storeHash(beam->table, scratch->hashes[j], bits);
+    }
+  }
+}
+
+void *runBeamWorker(void *arg) {
+  BeamWorker_t *worker = arg;
+  Beam_t *beam = worker->beam;
+  unsigned long generation = 0;
+
+  pthread_mutex_lock(&beam->mutex);
+  while (beam->isActive) {
+    if (beam->generation == generation) {
+      pthread_cond_wait(&beam->start, &beam->mutex);
+    } else {
+      generation = beam->generation;
+      pthread_mutex_unlock(&beam->mutex);
+
+      expandBeam(beam, worker);
+
+      pthread_mutex_lock(&beam->mutex);
+      if (--beam->pending == 0) pthread_cond_signal(&beam->done);
+    }
+  }
+  pthread_mutex_unlock(&beam->mutex);
+
+  return NULL;
+}
+
+void insertBeamNode(BeamNode_t *nodes, int *count, int width,
+                    const BeamNode_t *node) {
+  int position = *count;
+  while (position > 0 && isBetterNode(node, &nodes[position - 1])) {
+    --position;
+  }
+
+  if (position > 0 && isSameBoard(node, &nodes[position - 1])) {
+    // The same board is already kept
+  } else if (position < *count && isSameBoard(node, &nodes[position])) {
+    nodes[position] = *node;
+  } else if (position < width) {
+    int moved = *count < width ? *count - position : width - 1 - position;
+    memmove(&nodes[position + 1], &nodes[position],
+            sizeof(nodes[0]) * (size_t)moved);
+    nodes[position] = *node;
+    if (*count < width) ++*count;
+  }
+}
+
+void removeBeam(Beam_t *beam) {
+  pthread_mutex_lock(&beam->mutex);
+  beam->isActive = false;
+  pthread_cond_broadcast(&beam->start);
+  pthread_mutex_unlock(&beam->mutex);
+
+  for (int i = 0; i < beam->threadsCount; ++i) {
+    if (i > 0) pthread_join(beam->workers[i].thread, NULL);
+    free(beam->workers[i].scratch);
+  }
+
+  pthread_mutex_destroy(&beam->mutex);
+  pthread_cond_destroy(&beam->start);
+  pthread_cond_destroy(&beam->done);
+  beam->threadsCount = 0;
+}
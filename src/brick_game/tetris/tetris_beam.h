@@ -0,0 +1,227 @@
+#ifndef BEAM_H
+#define BEAM_H
+
+/*****************************************************************************
+ * @file tetris_beam.h
+ * @brief Header File with Beam Search over Queue of Upcoming Figures
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+
+#include "tetris_board.h"
+#include "tetris_eval.h"
+#include "tetris_hash.h"
+#include "tetris_logic.h"
+
+#define BEAM_WIDTH 32
+#define BEAM_WIDTH_MAX 64
+#define BEAM_THREADS_MAX 16
+
+/*****************************************************************************
+ * @brief Beam node struct
+ *
+ * Board reached by placements of current and upcoming figures
+ *
+ * @param board Board after placements
+ * @param hash Zobrist hash of board
+ * @param score Evaluation of board
+ * @param lines Rows removed by all placements
+ * @param first Placement of current figure the node starts with
+ *****************************************************************************/
+typedef struct {
+  Board_t board;
+  uint64_t hash;
+  float score;
+  int lines;
+  Placement_t first;
+} BeamNode_t;
+
+/*****************************************************************************
+ * @brief Beam scratch struct
+ *
+ * Children of one node before they are scored and selected
+ *
+ * @param placements Placements of figure
+ * @param boards Boards after placements
+ * @param hashes Hashes of boards
+ * @param lines Rows removed by node and placement
+ * @param scores Evaluations of boards without removed rows
+ * @param missed Indexes of boards not found in transposition table
+ * @param missedBoards Boards not found in transposition table
+ * @param missedScores Evaluations of missed boards
+ *****************************************************************************/
+typedef struct {
+  Placement_t placements[PLACEMENTS_MAX];
+  Board_t boards[PLACEMENTS_MAX];
+  uint64_t hashes[PLACEMENTS_MAX];
+  int lines[PLACEMENTS_MAX];
+  float scores[PLACEMENTS_MAX];
+  int missed[PLACEMENTS_MAX];
+  Board_t missedBoards[PLACEMENTS_MAX];
+  float missedScores[PLACEMENTS_MAX];
+} BeamScratch_t;
+
+typedef struct Beam Beam_t;
+
+/*****************************************************************************
+ * @brief Beam worker struct
+ *
+ * @param thread Thread handle, worker 0 runs in thread of searchBeam
+ * @param index Index of worker: it expands nodes index, index + threadsCount...
+ * @param beam Beam the worker belongs to
+ * @param scratch Children of node being expanded
+ * @param nodes The best children of nodes expanded by worker, best first
+ * @param count Number of nodes
+ * @param isTimeout Flag that worker has stopped at deadline
+ *****************************************************************************/
+typedef struct {
+  pthread_t thread;
+  int index;
+  Beam_t *beam;
+  BeamScratch_t *scratch;
+  BeamNode_t nodes[BEAM_WIDTH_MAX];
+  int count;
+  bool isTimeout;
+} BeamWorker_t;
+
+/*****************************************************************************
+ * @brief Beam struct
+ *
+ * Beam search keeps width best distinct boards on every depth of queue. Nodes
+ *of depth are expanded by a pool of workers, every worker selects its own
+ *best children and searchBeam merges them. Evaluations of boards without
+ *removed rows are cached in transposition table shared by workers and by
+ *other beams that use the same weights
+ *
+ * @param width Number of nodes kept on every depth: [1..BEAM_WIDTH_MAX]
+ * @param nodes Nodes of current depth, best first
+ * @param count Number of nodes
+ * @param figure Current figure, expanded at depth 0 from its position
+ * @param type Type of figure of depth being expanded
+ * @param depth Depth being expanded
+ * @param weights Weights of evaluation
+ * @param table Transposition table of evaluations or NULL
+ * @param deadline Monotonic time in ns to stop expanding
+ * @param workers Workers of pool
+ * @param threadsCount Number of workers
+ * @param mutex Mutex of pool
+ * @param start Condition of new depth to expand
+ * @param done Condition of all workers done
+ * @param generation Number of depths given to workers
+ * @param pending Number of workers expanding current depth
+ * @param isActive Flag for activate worker threads
+ *****************************************************************************/
+struct Beam {
+  int width;
+  BeamNode_t nodes[BEAM_WIDTH_MAX];
+  int count;
+  Figure_t figure;
+  int type;
+  int depth;
+  const Weights_t *weights;
+  HashTable_t *table;
+  long long deadline;
+  BeamWorker_t workers[BEAM_THREADS_MAX];
+  int threadsCount;
+  pthread_mutex_t mutex;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long generation;
+  int pending;
+  bool isActive;
+};
+
+/*****************************************************************************
+ * @brief Initialize beam
+ *
+ * Allocate scratch of workers and start worker threads
+ *
+ * @param beam Pointer to struct of Beam_t
+ * @param width Number of nodes kept on every depth: [1..BEAM_WIDTH_MAX]
+ * @param threadsCount Number of workers, 0 for number of online CPUs
+ *****************************************************************************/
+void initializeBeam(Beam_t *beam, int width, int threadsCount);
+
+/*****************************************************************************
+ * @brief Search beam
+ *
+ * Search placements of current figure and every upcoming figure, keeping
+ *width best boards on every depth. Depth 0 is always searched, deeper ones
+ *while deadline is not passed
+ *
+ * @param beam Pointer to struct of Beam_t
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param types Types of upcoming figures
+ * @param typesCount Number of upcoming figures
+ * @param weights Pointer to weights of evaluation
+ * @param deadline Monotonic time in ns to return the best placement so far
+ * @param placement Pointer to placement of current figure to fill
+ * @return int Number of fully searched depths, 0 if figure has no placements
+ *****************************************************************************/
+int searchBeam(Beam_t *beam, const Board_t *board, const Figure_t *figure,
+               const int *types, int typesCount, const Weights_t *weights,
+               long long deadline, Placement_t *placement);
+
+/*****************************************************************************
+ * @brief Expand beam
+ *
+ * Expand nodes of worker on current depth into its best children
+ *
+ * @param beam Pointer to struct of Beam_t
+ * @param worker Pointer to struct of BeamWorker_t
+ *****************************************************************************/
+void expandBeam(Beam_t *beam, BeamWorker_t *worker);
+
+/*****************************************************************************
+ * @brief Score beam children
+ *
+ * Evaluate children without removed rows, taking evaluations from
+ *transposition table if beam has one and storing the new ones
+ *
+ * @param beam Pointer to struct of Beam_t
+ * @param scratch Pointer to children with boards and hashes
+ * @param count Number of children
+ *****************************************************************************/
+void scoreBeamChildren(Beam_t *beam, BeamScratch_t *scratch, int count);
+
+/*****************************************************************************
+ * @brief Beam worker loop
+ *
+ * Thread routine: expand every depth given by searchBeam until beam is
+ *removed
+ *
+ * @param arg Pointer to struct of BeamWorker_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *runBeamWorker(void *arg);
+
+/*****************************************************************************
+ * @brief Insert beam node
+ *
+ * Insert node into array of the best nodes ordered by score. Ties are ordered
+ *by hash and first placement, so selection doesn't depend on workers. Node
+ *with the same board as another one is kept only if it is ordered first
+ *
+ * @param nodes Array of width nodes, best first
+ * @param count Pointer to number of nodes
+ * @param width Maximum number of nodes
+ * @param node Pointer to node to insert
+ *****************************************************************************/
+void insertBeamNode(BeamNode_t *nodes, int *count, int width,
+                    const BeamNode_t *node);
+
+/*****************************************************************************
+ * @brief Remove beam
+ *
+ * Stop and join worker threads and clear allocated memory
+ *
+ * @param beam Pointer to struct of Beam_t
+ *****************************************************************************/
+void removeBeam(Beam_t *beam);
+
+#endif  // BEAM_H
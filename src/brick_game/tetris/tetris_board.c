@@ -0,0 +1,204 @@
+/*****************************************************************************
+ * @file tetris_board.c
+ * @brief Source File with Compact Board and Placement Generator
+ *****************************************************************************/
+
+#include "tetris_board.h"
+
+#include <pthread.h>
+#include <string.h>
+
+static Piece_t pieces[FIGURES_COUNT][ROTATIONS_COUNT];
+static pthread_once_t piecesOnce = PTHREAD_ONCE_INIT;
+
+void initializePieces(void) {
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    for (int rotation = 0; rotation < ROTATIONS_COUNT; ++rotation) {
+      Piece_t *piece = &pieces[type][rotation];
+      int xx[4], yy[4];
+      piece->top = FIELD_HEIGHT;
+      piece->left = FIELD_WIDTH;
+      int bottom = -FIELD_HEIGHT;
+
+      for (int i = 1; i < 8; i += 2) {
+        xx[i / 2] = (int)round(figures[type][i] * cos(PI_2 * rotation) +
+                               figures[type][i - 1] * sin(PI_2 * rotation));
+        yy[i / 2] = (int)round(-figures[type][i] * sin(PI_2 * rotation) +
+                               figures[type][i - 1] * cos(PI_2 * rotation));
+
+        if (yy[i / 2] < piece->top) piece->top = yy[i / 2];
+        if (yy[i / 2] > bottom) bottom = yy[i / 2];
+        if (xx[i / 2] < piece->left) piece->left = xx[i / 2];
+      }
+
+      piece->height = bottom - piece->top + 1;
+      memset(piece->rows, 0, sizeof(piece->rows));
+      for (int i = 0; i < 4; ++i) {
+        piece->rows[yy[i] - piece->top] |=
+            (uint16_t)(1u << (xx[i] - piece->left));
+      }
+
+      piece->shape = rotation;
+      for (int other = rotation - 1; other >= 0; --other) {
+        const Piece_t *same = &pieces[type][other];
+
+        if (same->height == piece->height &&
+            memcmp(same->rows, piece->rows, sizeof(piece->rows)) == 0) {
+          piece->shape = same->shape;
+        }
+      }
+    }
+  }
+}
+
+const Piece_t *getPiece(int type, int rotation) {
+  pthread_once(&piecesOnce, initializePieces);
+
+  return &pieces[type][rotation];
+}
+
+void initializeBoard(Board_t *board, int **field, const Figure_t *figure) {
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    board->rows[row] = 0;
+
+    for (int col = 0; col < FIELD_WIDTH; ++col) {
+      if (field[row][col]) {
+        board->rows[row] |= (uint16_t)(1u << col);
+      }
+    }
+  }
+
+  if (figure) {
+    const Piece_t *piece = getPiece(figure->type, figure->rotation);
+
+    for (int k = 0; k < piece->height; ++k) {
+      board->rows[figure->y + piece->top + k] &=
+          (uint16_t)~(piece->rows[k] << (figure->x + piece->left));
+    }
+  }
+}
+
+void resetBoard(Board_t *board) {
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    board->rows[row] =
+        row > FIELD_HEIGHT - BORDER_SIZE - 1
+            ? (uint16_t)((1u << FIELD_WIDTH) - 1)
+            : (uint16_t)(((1u << BORDER_SIZE) - 1) |
+                         ((1u << BORDER_SIZE) - 1)
+                             << (FIELD_WIDTH - BORDER_SIZE));
+  }
+}
+
+bool isPieceCollide(const Board_t *board, const Piece_t *piece, int x, int y) {
+  const uint16_t *rows = board->rows + y + piece->top;
+  int shift = x + piece->left;
+  unsigned collision = 0;
+
+  for (int k = 0; k < piece->height; ++k) {
+    collision |= rows[k] & ((unsigned)piece->rows[k] << shift);
+  }
+
+  return collision != 0;
+}
+
+int generatePlacements(const Board_t *board, const Figure_t *figure,
+                       Placement_t *placements) {
+  const Piece_t *rotations[ROTATIONS_COUNT];
+  for (int rotation = 0; rotation < ROTATIONS_COUNT; ++rotation) {
+    rotations[rotation] = getPiece(figure->type, rotation);
+  }
+
+  // Bit x of tested[rotation][y] is set once state is tested for collision,
+  // bit x of reachable[rotation][y] is set if it doesn't collide
+  uint16_t tested[ROTATIONS_COUNT][FIELD_HEIGHT] = {{0}};
+  uint16_t reachable[ROTATIONS_COUNT][FIELD_HEIGHT] = {{0}};
+  uint16_t placed[ROTATIONS_COUNT][FIELD_HEIGHT] = {{0}};
+  Placement_t queue[PLACEMENTS_MAX];
+  int head = 0;
+  int tail = 0;
+  int count = 0;
+
+  Placement_t start = {(unsigned char)figure->x, (unsigned char)figure->y,
+                       (unsigned char)figure->rotation};
+  tested[start.rotation][start.y] |= (uint16_t)(1u << start.x);
+  if (!isPieceCollide(board, rotations[start.rotation], start.x, start.y)) {
+    reachable[start.rotation][start.y] |= (uint16_t)(1u << start.x);
+    queue[tail++] = start;
+  }
+
+  while (head < tail) {
+    Placement_t state = queue[head++];
+    int x = state.x;
+    int y = state.y;
+    int rotation = state.rotation;
+
+    Placement_t moves[4] = {
+        {(unsigned char)(x - 1), state.y, state.rotation},  // moveLeft
+        {(unsigned char)(x + 1), state.y, state.rotation},  // moveRight
+        {state.x, state.y,
+         (unsigned char)((rotation + 1) % ROTATIONS_COUNT)},  // rotateFigure
+        {state.x, (unsigned char)(y + 1), state.rotation}     // shiftFigure
+    };
+
+    for (int i = 0; i < 4; ++i) {
+      Placement_t move = moves[i];
+      uint16_t bit = (uint16_t)(1u << move.x);
+
+      if (!(tested[move.rotation][move.y] & bit)) {
+        tested[move.rotation][move.y] |= bit;
+
+        if (!isPieceCollide(board, rotations[move.rotation], move.x,
+                            move.y)) {
+          reachable[move.rotation][move.y] |= bit;
+          queue[tail++] = move;
+        }
+      }
+    }
+
+    // Figure that can't shift down is attached: a placement
+    if (!(reachable[rotation][y + 1] & (1u << x))) {
+      const Piece_t *piece = rotations[rotation];
+      uint16_t *shape = &placed[piece->shape][y + piece->top];
+      uint16_t pixel = (uint16_t)(1u << (x + piece->left));
+
+      if (!(*shape & pixel)) {
+        *shape |= pixel;
+        placements[count++] = state;
+      }
+    }
+  }
+
+  return count;
+}
+
+bool spawnBoardFigure(const Board_t *board, int type, Figure_t *figure) {
+  figure->type = type;
+  figure->rotation = 0;
+  figure->x = FIELD_WIDTH / 2;
+  figure->y = 3;
+
+  return !isPieceCollide(board, getPiece(type, 0), figure->x, figure->y);
+}
+
+int placePiece(Board_t *board, const Piece_t *piece, int x, int y) {
+  for (int k = 0; k < piece->height; ++k) {
+    board->rows[y + piece->top + k] |=
+        (uint16_t)(piece->rows[k] << (x + piece->left));
+  }
+
+  return removeBoardRows(board);
+}
+
+int removeBoardRows(Board_t *board) {
+  int rows = 0;
+
+  for (int row = FIELD_HEIGHT - BORDER_SIZE - 1; row > 2; --row) {
+    while ((board->rows[row] & ROW_FULL) == ROW_FULL) {
+      ++rows;
+      memmove(board->rows + 2, board->rows + 1,
+              (size_t)(row - 1) * sizeof(board->rows[0]));
+    }
+  }
+
+  return rows;
+}
@@ -0,0 +1,169 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+/*****************************************************************************
+ * @file tetris_board.h
+ * @brief Header File with Compact Board and Placement Generator
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#include "tetris_logic.h"
+
+#define ROTATIONS_COUNT (ROTATION_MAX + 1)
+#define PIECE_HEIGHT 4
+#define PLACEMENTS_MAX (ROTATIONS_COUNT * FIELD_WIDTH * FIELD_HEIGHT)
+#define ROW_FULL \
+  ((uint16_t)(((1u << (FIELD_WIDTH - BORDER_SIZE * 2)) - 1) << BORDER_SIZE))
+
+/*****************************************************************************
+ * @brief Compact board struct
+ *
+ * Field as one bit per pixel: bit col of rows[row] is set if pixel is not
+ *empty. Borders are kept, so collision tests need no bounds checks
+ *
+ * @param rows Rows of field
+ *****************************************************************************/
+typedef struct {
+  uint16_t rows[FIELD_HEIGHT];
+} Board_t;
+
+/*****************************************************************************
+ * @brief Piece struct
+ *
+ * Figure of one type in one rotation as row masks. Pixel of mask row k and
+ *bit b is at field row y + top + k and col x + left + b for figure center
+ *(x, y)
+ *
+ * @param rows Row masks
+ * @param top Row offset of the first mask row from figure center
+ * @param left Col offset of mask bit 0 from figure center
+ * @param height Number of mask rows
+ * @param shape The lowest rotation with the same masks: pieces of the same
+ *shape at the same (x + left, y + top) cover the same pixels
+ *****************************************************************************/
+typedef struct {
+  uint16_t rows[PIECE_HEIGHT];
+  int top;
+  int left;
+  int height;
+  int shape;
+} Piece_t;
+
+/*****************************************************************************
+ * @brief Placement struct
+ *
+ * Final position of figure where it can't fall anymore
+ *
+ * @param x X coordinate of figure center
+ * @param y Y coordinate of figure center
+ * @param rotation Number of rotation to PI/2 angle: [0..3]
+ *****************************************************************************/
+typedef struct {
+  unsigned char x;
+  unsigned char y;
+  unsigned char rotation;
+} Placement_t;
+
+/*****************************************************************************
+ * @brief Initialize pieces
+ *
+ * Build row masks of every figure in every rotation with the same rotation
+ *rule as game logic. Called once by getPiece
+ *****************************************************************************/
+void initializePieces(void);
+
+/*****************************************************************************
+ * @brief Get piece
+ *
+ * @param type Type of figure
+ * @param rotation Number of rotation to PI/2 angle: [0..3]
+ * @return const Piece_t* Row masks of figure
+ *****************************************************************************/
+const Piece_t *getPiece(int type, int rotation);
+
+/*****************************************************************************
+ * @brief Initialize board
+ *
+ * Convert game field to compact board
+ *
+ * @param board Pointer to struct of Board_t
+ * @param field Game field with borders
+ * @param figure Falling figure to leave out of board or NULL
+ *****************************************************************************/
+void initializeBoard(Board_t *board, int **field, const Figure_t *figure);
+
+/*****************************************************************************
+ * @brief Reset board
+ *
+ * Make board empty with borders only
+ *
+ * @param board Pointer to struct of Board_t
+ *****************************************************************************/
+void resetBoard(Board_t *board);
+
+/*****************************************************************************
+ * @brief Check collision of piece
+ *
+ * @param board Pointer to struct of Board_t
+ * @param piece Pointer to struct of Piece_t
+ * @param x X coordinate of figure center
+ * @param y Y coordinate of figure center
+ * @return bool True if piece overlaps non-empty pixels of board
+ *****************************************************************************/
+bool isPieceCollide(const Board_t *board, const Piece_t *piece, int x, int y);
+
+/*****************************************************************************
+ * @brief Generate placements
+ *
+ * Search breadth-first over (x, y, rotation) states reachable from figure by
+ *moveLeft, moveRight, rotateFigure and gravity shift, so tucks and spins
+ *under overhangs are found. Every state that can't fall is a placement,
+ *placements with the same set of pixels are returned once
+ *
+ * @param board Pointer to struct of Board_t without figure
+ * @param figure Pointer to figure with type, rotation and center to start from
+ * @param placements Array of at least PLACEMENTS_MAX placements to fill
+ * @return int Number of placements, 0 if figure collides at start
+ *****************************************************************************/
+int generatePlacements(const Board_t *board, const Figure_t *figure,
+                       Placement_t *placements);
+
+/*****************************************************************************
+ * @brief Spawn figure
+ *
+ * Put figure of type to spawn position the same way as attachFigure does:
+ *one row below spawnNextFigure position
+ *
+ * @param board Pointer to struct of Board_t
+ * @param type Type of figure
+ * @param figure Pointer to figure to fill
+ * @return bool False if figure collides at spawn: game over
+ *****************************************************************************/
+bool spawnBoardFigure(const Board_t *board, int type, Figure_t *figure);
+
+/*****************************************************************************
+ * @brief Place piece
+ *
+ * Add piece to board and remove full rows
+ *
+ * @param board Pointer to struct of Board_t
+ * @param piece Pointer to struct of Piece_t
+ * @param x X coordinate of figure center
+ * @param y Y coordinate of figure center
+ * @return int Number of removed rows
+ *****************************************************************************/
+int placePiece(Board_t *board, const Piece_t *piece, int x, int y);
+
+/*****************************************************************************
+ * @brief Remove full rows of board
+ *
+ * Remove full rows and shift rows above them down exactly as removeFullRows
+ *does with game field
+ *
+ * @param board Pointer to struct of Board_t
+ * @return int Number of removed rows
+ *****************************************************************************/
+int removeBoardRows(Board_t *board);
+
+#endif  // BOARD_H
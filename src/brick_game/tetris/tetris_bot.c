@@ -0,0 +1,399 @@
+/*****************************************************************************
+ * @file tetris_bot.c
+ * @brief Source File with Autoplay Bot of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_bot.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+static pthread_once_t pathsOnce = PTHREAD_ONCE_INIT;
+static PathCache_t paths[FIGURES_COUNT][ROTATIONS_COUNT][FIELD_WIDTH];
+
+static bool isAt(const Figure_t *figure, const Placement_t *state) {
+  return figure->x == state->x && figure->y == state->y &&
+         figure->rotation == state->rotation;
+}
+
+void initializeBot(Bot_t *bot, const Weights_t *weights, long long budget) {
+  bot->weights = weights ? *weights : defaultWeights;
+  bot->budget = budget;
+  bot->actionsCount = 0;
+  bot->actionIndex = 0;
+  bot->spawnCount = 0;
+  bot->pc = NULL;
+  bot->beam = NULL;
+  bot->expect = NULL;
+  bot->rollout = NULL;
+}
+
+UserAction_t getBotAction(Bot_t *bot, GameParameters_t *parameters) {
+  UserAction_t action = Up;
+  const Figure_t *figure = parameters->figure;
+
+  if (parameters->state != GAME) {
+    action = Start;
+  } else if (!parameters->data->pause) {
+    if (bot->spawnCount != parameters->spawnCount) {
+      planBot(bot, parameters);
+    }
+
+    // Skip waits that gravity has already done
+    while (bot->actionIndex < bot->actionsCount &&
+           bot->actions[bot->actionIndex] == Up &&
+           isAt(figure, &bot->states[bot->actionIndex])) {
+      bot->expected = bot->states[bot->actionIndex++];
+    }
+
+    if (!isAt(figure, &bot->expected)) {
+      planBot(bot, parameters);
+    }
+
+    if (bot->actionIndex < bot->actionsCount &&
+        bot->actions[bot->actionIndex] != Up) {
+      action = bot->actions[bot->actionIndex];
+      bot->expected = bot->states[bot->actionIndex++];
+    }
+  }
+
+  return action;
+}
+
+void planBot(Bot_t *bot, GameParameters_t *parameters) {
+  long long deadline = getBotTime() + bot->budget;
+  const Figure_t *figure = parameters->figure;
+  Board_t board;
+  Placement_t placement;
+  bool isChosen = false;
+
+  initializeBoard(&board, parameters->data->field, figure);
+
+  bot->spawnCount = parameters->spawnCount;
+  bot->expected = (Placement_t){(unsigned char)figure->x,
+                                (unsigned char)figure->y,
+                                (unsigned char)figure->rotation};
+  bot->actionIndex = 0;
+  bot->actionsCount = 0;
+
+  int types[QUEUE_MAX];
+  for (int i = 0; i < parameters->queueLength; ++i) {
+    types[i] = getQueuedFigure(parameters, i);
+  }
+
+  if (bot->pc) {
+    Placement_t solution[PC_PIECES_MAX];
+    long long pcDeadline = getBotTime() + PC_BUDGET;
+
+    isChosen = solvePerfectClear(bot->pc, &board, figure, types,
+                                 parameters->queueLength,
+                                 pcDeadline < deadline ? pcDeadline : deadline,
+                                 solution) > 0;
+    if (isChosen) placement = solution[0];
+  }
+
+  if (isChosen) {
+    // Perfect clear is played
+  } else if (bot->beam) {
+    isChosen = searchBeam(bot->beam, &board, figure, types,
+                          parameters->queueLength, &bot->weights, deadline,
+                          &placement) > 0;
+  } else if (bot->expect) {
+    isChosen = chooseExpectimax(bot->expect, &board, figure, types,
+                                parameters->queueLength, deadline,
+                                &placement);
+  } else if (bot->rollout) {
+    isChosen = searchRollout(bot->rollout, &board, figure, figure->typeNext,
+                             deadline, &placement) > 0;
+  } else {
+    isChosen = choosePlacement(&board, figure, figure->typeNext,
+                               &bot->weights, deadline, &placement);
+  }
+
+  if (isChosen) {
+    bot->actionsCount =
+        findPath(&board, figure, &placement, bot->actions, bot->states);
+  }
+}
+
+bool choosePlacement(const Board_t *board, const Figure_t *figure,
+                     int typeNext, const Weights_t *weights,
+                     long long deadline, Placement_t *placement) {
+  Placement_t placements[PLACEMENTS_MAX];
+  Board_t boards[PLACEMENTS_MAX];
+  int lines[PLACEMENTS_MAX];
+  float scores[PLACEMENTS_MAX];
+  int order[PLACEMENTS_MAX];
+  int count = generatePlacements(board, figure, placements);
+
+  for (int i = 0; i < count; ++i) {
+    boards[i] = *board;
+    lines[i] = placePiece(&boards[i],
+                          getPiece(figure->type, placements[i].rotation),
+                          placements[i].x, placements[i].y);
+  }
+
+  evaluateBoards(boards, lines, count, weights, scores);
+
+  // Order placements by their own score, the best first
+  for (int i = 0; i < count; ++i) {
+    int j = i;
+    for (; j > 0 && scores[order[j - 1]] < scores[i]; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+  }
+
+  int best = count > 0 ? order[0] : -1;
+  float bestScore = -INFINITY;
+  Placement_t nextPlacements[PLACEMENTS_MAX];
+  Board_t nextBoards[PLACEMENTS_MAX];
+  int nextLines[PLACEMENTS_MAX];
+  float nextScores[PLACEMENTS_MAX];
+
+  for (int k = 0; k < count && getBotTime() < deadline; ++k) {
+    int i = order[k];
+    float score = -INFINITY;
+    Figure_t next;
+
+    if (spawnBoardFigure(&boards[i], typeNext, &next)) {
+      int nextCount = generatePlacements(&boards[i], &next, nextPlacements);
+
+      for (int j = 0; j < nextCount; ++j) {
+        nextBoards[j] = boards[i];
+        nextLines[j] =
+            lines[i] +
+            placePiece(&nextBoards[j],
+                       getPiece(typeNext, nextPlacements[j].rotation),
+                       nextPlacements[j].x, nextPlacements[j].y);
+      }
+
+      evaluateBoards(nextBoards, nextLines, nextCount, weights, nextScores);
+
+      for (int j = 0; j < nextCount; ++j) {
+        if (nextScores[j] > score) score = nextScores[j];
+      }
+    }
+
+    if (k == 0 || score > bestScore) {
+      best = i;
+      bestScore = score;
+    }
+  }
+
+  if (best >= 0) *placement = placements[best];
+
+  return best >= 0;
+}
+
+void initializePaths(void) {
+  Board_t board;
+  Placement_t placements[PLACEMENTS_MAX];
+  UserAction_t actions[BOT_ACTIONS_MAX];
+  Placement_t states[BOT_ACTIONS_MAX];
+  resetBoard(&board);
+
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Figure_t figure;
+    spawnBoardFigure(&board, type, &figure);
+    int count = generatePlacements(&board, &figure, placements);
+
+    for (int i = 0; i < count; ++i) {
+      const Piece_t *target = getPiece(type, placements[i].rotation);
+      int column = placements[i].x + target->left;
+      int length =
+          searchPath(&board, &figure, &placements[i], actions, states);
+      bool isTop = length > 0 && length <= PATH_LENGTH_MAX;
+
+      // Only paths without waits stay valid on any board with empty top
+      for (int k = 0; k < length - 1 && isTop; ++k) {
+        isTop = actions[k] != Up;
+      }
+
+      if (isTop) {
+        PathCache_t *path = &paths[type][target->shape][column];
+        path->length = length;
+        memcpy(path->actions, actions, sizeof(actions[0]) * (size_t)length);
+      }
+    }
+  }
+}
+
+int findPath(const Board_t *board, const Figure_t *figure,
+             const Placement_t *placement, UserAction_t *actions,
+             Placement_t *states) {
+  int count = findCachedPath(board, figure, placement, actions, states);
+
+  if (count == 0) {
+    count = searchPath(board, figure, placement, actions, states);
+  }
+
+  return count;
+}
+
+int findCachedPath(const Board_t *board, const Figure_t *figure,
+                   const Placement_t *placement, UserAction_t *actions,
+                   Placement_t *states) {
+  const Piece_t *target = getPiece(figure->type, placement->rotation);
+  int column = placement->x + target->left;
+  bool isEmpty = figure->x == FIELD_WIDTH / 2 && figure->rotation == 0 &&
+                 column >= 0 && column < FIELD_WIDTH;
+  int count = 0;
+
+  pthread_once(&pathsOnce, initializePaths);
+
+  for (int row = 0; row < figure->y + PIECE_HEIGHT && isEmpty; ++row) {
+    isEmpty = !(board->rows[row] & ROW_FULL);
+  }
+
+  const PathCache_t *path =
+      isEmpty ? &paths[figure->type][target->shape][column] : NULL;
+
+  if (path && path->length > 0) {
+    Placement_t state = {(unsigned char)figure->x, (unsigned char)figure->y,
+                         (unsigned char)figure->rotation};
+
+    for (int k = 0; k < path->length - 1; ++k) {
+      if (path->actions[k] == Left) {
+        state.x--;
+      } else if (path->actions[k] == Right) {
+        state.x++;
+      } else {
+        state.rotation = (unsigned char)((state.rotation + 1) %
+                                         ROTATIONS_COUNT);
+      }
+
+      actions[k] = path->actions[k];
+      states[k] = state;
+    }
+
+    const Piece_t *piece = getPiece(figure->type, state.rotation);
+    int y = state.y;
+    while (!isPieceCollide(board, piece, state.x, y + 1)) ++y;
+
+    // Figure lands elsewhere if the target is tucked under an overhang
+    if (y + piece->top == placement->y + target->top) {
+      count = path->length;
+      actions[count - 1] = Down;
+      states[count - 1] = (Placement_t){state.x, (unsigned char)y,
+                                        state.rotation};
+    }
+  }
+
+  return count;
+}
+
+int searchPath(const Board_t *board, const Figure_t *figure,
+               const Placement_t *placement, UserAction_t *actions,
+               Placement_t *states) {
+  const Piece_t *target = getPiece(figure->type, placement->rotation);
+  int targetY = placement->y + target->top;
+  int targetX = placement->x + target->left;
+
+  // Search tree: every state keeps its parent and the action leading to it
+  Placement_t queue[PLACEMENTS_MAX];
+  int parents[PLACEMENTS_MAX];
+  UserAction_t moves[PLACEMENTS_MAX];
+  uint16_t visited[ROTATIONS_COUNT][FIELD_HEIGHT] = {{0}};
+  int head = 0;
+  int tail = 0;
+  int found = -1;
+
+  Placement_t start = {(unsigned char)figure->x, (unsigned char)figure->y,
+                       (unsigned char)figure->rotation};
+  visited[start.rotation][start.y] |= (uint16_t)(1u << start.x);
+  if (!isPieceCollide(board, getPiece(figure->type, start.rotation), start.x,
+                      start.y)) {
+    parents[tail] = -1;
+    queue[tail++] = start;
+  }
+
+  // Layer of states reached by the same number of inputs, waits are free
+  for (int inputs = 0; head < tail && found < 0 && inputs < BOT_ACTIONS_MAX;
+       ++inputs) {
+    for (int index = head; index < tail; ++index) {
+      Placement_t state = queue[index];
+      const Piece_t *piece = getPiece(figure->type, state.rotation);
+      Placement_t below = {state.x, (unsigned char)(state.y + 1),
+                           state.rotation};
+      bool isFree = !isPieceCollide(board, piece, below.x, below.y);
+      uint16_t bit = (uint16_t)(1u << below.x);
+
+      if (isFree && !(visited[below.rotation][below.y] & bit)) {
+        visited[below.rotation][below.y] |= bit;
+        parents[tail] = index;
+        moves[tail] = Up;
+        queue[tail++] = below;
+      }
+
+      int y = state.y;
+      while (!isPieceCollide(board, piece, state.x, y + 1)) ++y;
+
+      // The highest state of layer has the fewest waits
+      if (piece->shape == target->shape && y + piece->top == targetY &&
+          state.x + piece->left == targetX &&
+          (found < 0 || state.y < queue[found].y)) {
+        found = index;
+      }
+    }
+
+    for (int end = tail; head < end && found < 0; ++head) {
+      Placement_t state = queue[head];
+      Placement_t next[3] = {
+          {(unsigned char)(state.x - 1), state.y, state.rotation},
+          {(unsigned char)(state.x + 1), state.y, state.rotation},
+          {state.x, state.y,
+           (unsigned char)((state.rotation + 1) % ROTATIONS_COUNT)}};
+      UserAction_t nextMoves[3] = {Left, Right, Action};
+
+      for (int i = 0; i < 3; ++i) {
+        uint16_t bit = (uint16_t)(1u << next[i].x);
+
+        if (!(visited[next[i].rotation][next[i].y] & bit)) {
+          visited[next[i].rotation][next[i].y] |= bit;
+
+          if (!isPieceCollide(board, getPiece(figure->type, next[i].rotation),
+                              next[i].x, next[i].y)) {
+            parents[tail] = head;
+            moves[tail] = nextMoves[i];
+            queue[tail++] = next[i];
+          }
+        }
+      }
+    }
+  }
+
+  int count = 0;
+  if (found >= 0) {
+    int length = 1;
+    for (int i = found; parents[i] >= 0; i = parents[i]) ++length;
+
+    if (length <= BOT_ACTIONS_MAX) {
+      const Piece_t *piece = getPiece(figure->type, queue[found].rotation);
+      int y = queue[found].y;
+      while (!isPieceCollide(board, piece, queue[found].x, y + 1)) ++y;
+
+      count = length;
+      actions[length - 1] = Down;
+      states[length - 1] =
+          (Placement_t){queue[found].x, (unsigned char)y,
+                        queue[found].rotation};
+
+      for (int i = found, k = length - 2; parents[i] >= 0;
+           i = parents[i], --k) {
+        actions[k] = moves[i];
+        states[k] = queue[i];
+      }
+    }
+  }
+
+  return count;
+}
+
+long long getBotTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
@@ -0,0 +1,198 @@
+#ifndef BOT_H
+#define BOT_H
+
+/*****************************************************************************
+ * @file tetris_bot.h
+ * @brief Header File with Autoplay Bot of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tetris_beam.h"
+#include "tetris_board.h"
+#include "tetris_eval.h"
+#include "tetris_expect.h"
+#include "tetris_logic.h"
+#include "tetris_pc.h"
+#include "tetris_rollout.h"
+
+#define BOT_ACTIONS_MAX 64
+#define BOT_BUDGET 4000000LL  // ns of search per figure
+#define PATH_LENGTH_MAX 16    // inputs of cached path with hard drop
+
+/*****************************************************************************
+ * @brief Bot struct
+ *
+ * Autoplay driver of one game. Bot plans once per spawned figure and then
+ *gives actions of the plan one by one, Up stands for waiting one gravity
+ *shift. The figure is checked against the plan before every action and
+ *the plan is made again if they differ
+ *
+ * @param weights Weights of board evaluation
+ * @param budget Time of search per figure in ns
+ * @param actions Planned actions, the last one is Down
+ * @param states Expected figure position after every planned action
+ * @param actionsCount Number of planned actions
+ * @param actionIndex Index of the next action
+ * @param expected Expected figure position before the next action
+ * @param spawnCount Spawn count of game the plan is made for
+ * @param pc Perfect clear solver tried before other searches, NULL for none
+ * @param beam Beam search over queue of upcoming figures, NULL to look ahead
+ *only at the next figure
+ * @param expect Expectimax search used if beam is NULL, NULL for none
+ * @param rollout Monte Carlo rollout search used instead of evaluation if beam
+ *and expect are NULL, NULL for none
+ *****************************************************************************/
+typedef struct {
+  Weights_t weights;
+  long long budget;
+  UserAction_t actions[BOT_ACTIONS_MAX];
+  Placement_t states[BOT_ACTIONS_MAX];
+  int actionsCount;
+  int actionIndex;
+  Placement_t expected;
+  unsigned long spawnCount;
+  PerfectClear_t *pc;
+  Beam_t *beam;
+  Expectimax_t *expect;
+  Rollout_t *rollout;
+} Bot_t;
+
+/*****************************************************************************
+ * @brief Path cache struct
+ *
+ * Inputs that lead figure from spawn position to a column in a rotation
+ *while all rows of the way are empty
+ *
+ * @param actions Inputs without waits ended with Down
+ * @param length Number of inputs, 0 if path isn't cached
+ *****************************************************************************/
+typedef struct {
+  UserAction_t actions[PATH_LENGTH_MAX];
+  int length;
+} PathCache_t;
+
+/*****************************************************************************
+ * @brief Initialize bot
+ *
+ * @param bot Pointer to struct of Bot_t
+ * @param weights Pointer to weights of evaluation or NULL for defaultWeights
+ * @param budget Time of search per figure in ns
+ *****************************************************************************/
+void initializeBot(Bot_t *bot, const Weights_t *weights, long long budget);
+
+/*****************************************************************************
+ * @brief Get bot action
+ *
+ * Get the next action of bot for current game state: Start on start and game
+ *over screens, next planned action during game. Call until it returns Up and
+ *pass every action to userInput or processAction
+ *
+ * @param bot Pointer to struct of Bot_t
+ * @param parameters Pointer to struct of GameParameters_t
+ * @return UserAction_t Action to apply or Up if there is nothing to do now
+ *****************************************************************************/
+UserAction_t getBotAction(Bot_t *bot, GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Plan bot actions
+ *
+ * Pick placement of current figure by beam search over queue of upcoming
+ *figures or by choosePlacement if bot has no beam, both within budget. Then
+ *find actions that lead current figure to picked placement
+ *
+ * @param bot Pointer to struct of Bot_t
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void planBot(Bot_t *bot, GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Choose placement
+ *
+ * Pick placement of current figure by the best evaluation of boards after
+ *current and next figure. Placements are refined with next figure in order
+ *of their own evaluation until deadline
+ *
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param typeNext Type of next figure
+ * @param weights Pointer to weights of evaluation
+ * @param deadline Monotonic time in ns to stop refining with next figure
+ * @param placement Pointer to placement to fill
+ * @return bool False if figure has no placements
+ *****************************************************************************/
+bool choosePlacement(const Board_t *board, const Figure_t *figure,
+                     int typeNext, const Weights_t *weights,
+                     long long deadline, Placement_t *placement);
+
+/*****************************************************************************
+ * @brief Initialize paths
+ *
+ * Search paths of every figure to every column in every rotation on empty
+ *board. Called once by findCachedPath
+ *****************************************************************************/
+void initializePaths(void);
+
+/*****************************************************************************
+ * @brief Find path
+ *
+ * Cached path if it is valid for board, otherwise searched one
+ *
+ * @param board Pointer to board without figure
+ * @param figure Pointer to figure to start from
+ * @param placement Pointer to target placement
+ * @param actions Array of BOT_ACTIONS_MAX actions to fill
+ * @param states Array of BOT_ACTIONS_MAX positions after actions to fill
+ * @return int Number of actions or 0 if there is no path
+ *****************************************************************************/
+int findPath(const Board_t *board, const Figure_t *figure,
+             const Placement_t *placement, UserAction_t *actions,
+             Placement_t *states);
+
+/*****************************************************************************
+ * @brief Find cached path
+ *
+ * Path from spawn position is taken from cache if rows of figure down to
+ *PIECE_HEIGHT below it are empty and figure dropped at the end of path lands
+ *as placement
+ *
+ * @param board Pointer to board without figure
+ * @param figure Pointer to figure to start from
+ * @param placement Pointer to target placement
+ * @param actions Array of BOT_ACTIONS_MAX actions to fill
+ * @param states Array of BOT_ACTIONS_MAX positions after actions to fill
+ * @return int Number of actions or 0 if path isn't cached for board
+ *****************************************************************************/
+int findCachedPath(const Board_t *board, const Figure_t *figure,
+                   const Placement_t *placement, UserAction_t *actions,
+                   Placement_t *states);
+
+/*****************************************************************************
+ * @brief Search path
+ *
+ * Breadth-first search over the movement rules of game: Left, Right and
+ *Action (blocked rotation keeps figure as is) cost one input, Up (wait for
+ *gravity) is free. Path has the fewest inputs, then the fewest waits, and is
+ *ended with Down (hard drop) that attaches figure as placement
+ *
+ * @param board Pointer to board without figure
+ * @param figure Pointer to figure to start from
+ * @param placement Pointer to target placement
+ * @param actions Array of BOT_ACTIONS_MAX actions to fill
+ * @param states Array of BOT_ACTIONS_MAX positions after actions to fill
+ * @return int Number of actions or 0 if there is no path
+ *****************************************************************************/
+int searchPath(const Board_t *board, const Figure_t *figure,
+               const Placement_t *placement, UserAction_t *actions,
+               Placement_t *states);
+
+/*****************************************************************************
+ * @brief Get monotonic time of bot clock
+ *
+ * @return long long Monotonic time in ns
+ *****************************************************************************/
+long long getBotTime(void);
+
+#endif  // BOT_H
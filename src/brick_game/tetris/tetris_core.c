@@ -0,0 +1,123 @@
+/*****************************************************************************
+ * @file tetris_core.c
+ * @brief Source File with Stable C Interface of the Tetris Game Core
+ *****************************************************************************/
+
+#include "tetris_core.h"
+
+#include "tetris_vec.h"
+
+// Public constants are copies: internal ones must not change under callers
+_Static_assert(TETRIS_ROWS == VEC_ROWS && TETRIS_COLS == VEC_COLS,
+               "field size of ABI");
+_Static_assert(TETRIS_FIGURES_COUNT == FIGURES_COUNT &&
+                   TETRIS_QUEUE_MAX == QUEUE_MAX &&
+                   TETRIS_PLANES_COUNT == VEC_PLANES_COUNT,
+               "planes of ABI");
+_Static_assert(TETRIS_ACTION_START == Start && TETRIS_ACTION_PAUSE == Pause &&
+                   TETRIS_ACTION_LEFT == Left && TETRIS_ACTION_RIGHT == Right &&
+                   TETRIS_ACTION_WAIT == Up && TETRIS_ACTION_DROP == Down &&
+                   TETRIS_ACTION_ROTATE == Action,
+               "actions of ABI");
+
+struct TetrisGame {
+  GameParameters_t parameters;
+  GameInfo_t data;
+  Figure_t figure;
+};
+
+struct TetrisVec {
+  VecEnv_t env;
+};
+
+static void *allocateCoreHandle(size_t size) {
+  void *handle = calloc(1, size);
+
+  if (NULL == handle) {
+    printf("\nNot enough memory...\n");
+    exit(1);
+  }
+
+  return handle;
+}
+
+uint32_t getTetrisCoreVersion(void) { return TETRIS_CORE_VERSION; }
+
+TetrisGame_t *createTetrisGame(uint32_t seed, int queueLength) {
+  TetrisGame_t *game = allocateCoreHandle(sizeof(*game));
+  GameParameters_t *parameters = &game->parameters;
+
+  parameters->data = &game->data;
+  parameters->figure = &game->figure;
+  initializeParametersPath(parameters, NULL);
+  seedParameters(parameters, seed);
+  setQueueLength(parameters, queueLength);
+  processAction(parameters, Start);
+
+  return game;
+}
+
+bool stepTetrisGame(TetrisGame_t *game, int action, uint32_t ticks) {
+  GameParameters_t *parameters = &game->parameters;
+
+  // Terminate frees field of game, only destroyTetrisGame may do it
+  if (action >= Start && action <= Action && action != Terminate) {
+    processAction(parameters, (UserAction_t)action);
+  }
+  updateTicks(parameters, parameters->ticks + ticks);
+
+  return parameters->state == GAME_OVER;
+}
+
+void readTetrisField(const TetrisGame_t *game, uint8_t *field) {
+  for (int row = 0; row < TETRIS_ROWS; ++row) {
+    for (int col = 0; col < TETRIS_COLS; ++col) {
+      field[row * TETRIS_COLS + col] =
+          (uint8_t)game->data.field[row + BORDER_SIZE][col + BORDER_SIZE];
+    }
+  }
+}
+
+int getTetrisScore(const TetrisGame_t *game) { return game->data.score; }
+
+void destroyTetrisGame(TetrisGame_t *game) {
+  if (game) {
+    removeParameters(&game->parameters);
+    free(game);
+  }
+}
+
+TetrisVec_t *createTetrisVec(int count, uint32_t seed, int gravity,
+                             int queueLength) {
+  TetrisVec_t *vec = allocateCoreHandle(sizeof(*vec));
+
+  initializeVecEnv(&vec->env, count, seed, gravity);
+  setVecQueueLength(&vec->env, queueLength);
+  enableVecPlanes(&vec->env);
+
+  return vec;
+}
+
+void stepTetrisVec(TetrisVec_t *vec, const uint8_t *actions, float *rewards,
+                   uint8_t *dones) {
+  stepVecEnv(&vec->env, actions, NULL, rewards, dones);
+}
+
+const uint8_t *getTetrisVecPlanes(const TetrisVec_t *vec) {
+  return vec->env.planes;
+}
+
+const uint8_t *getTetrisVecNextPlanes(const TetrisVec_t *vec) {
+  return vec->env.nextPlanes;
+}
+
+int getTetrisVecScore(const TetrisVec_t *vec, int index) {
+  return index >= 0 && index < vec->env.count ? vec->env.scores[index] : 0;
+}
+
+void destroyTetrisVec(TetrisVec_t *vec) {
+  if (vec) {
+    removeVecEnv(&vec->env);
+    free(vec);
+  }
+}
@@ -0,0 +1,171 @@
+#ifndef CORE_H
+#define CORE_H
+
+/*****************************************************************************
+ * @file tetris_core.h
+ * @brief Header File with Stable C Interface of the Tetris Game Core
+ *
+ * The only header needed to embed the game in another program through
+ *libtetris_core. Games and batched environments are opaque handles, so
+ *internal structs can change without breaking callers. Every function of this
+ *header is exported with symbol version TETRIS_CORE_1, all other symbols of
+ *the library are hidden
+ *****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TETRIS_CORE_VERSION_MAJOR 1  // changed by incompatible changes
+#define TETRIS_CORE_VERSION_MINOR 0  // changed by added functions
+#define TETRIS_CORE_VERSION \
+  ((TETRIS_CORE_VERSION_MAJOR << 16) | TETRIS_CORE_VERSION_MINOR)
+
+#define TETRIS_ROWS 20
+#define TETRIS_COLS 10
+#define TETRIS_FIGURES_COUNT 7
+#define TETRIS_QUEUE_MAX 6
+#define TETRIS_PLANES_COUNT 3  // occupancy, figure and ghost
+
+#define TETRIS_ACTION_START 0
+#define TETRIS_ACTION_PAUSE 1
+#define TETRIS_ACTION_LEFT 3
+#define TETRIS_ACTION_RIGHT 4
+#define TETRIS_ACTION_WAIT 5
+#define TETRIS_ACTION_DROP 6
+#define TETRIS_ACTION_ROTATE 7
+
+#if defined(__GNUC__)
+#define TETRIS_API __attribute__((visibility("default")))
+#else
+#define TETRIS_API
+#endif
+
+typedef struct TetrisGame TetrisGame_t;
+typedef struct TetrisVec TetrisVec_t;
+
+/*****************************************************************************
+ * @brief Get version of library
+ *
+ * Callers built with another TETRIS_CORE_VERSION_MAJOR must not use library
+ *
+ * @return uint32_t TETRIS_CORE_VERSION of library
+ *****************************************************************************/
+TETRIS_API uint32_t getTetrisCoreVersion(void);
+
+/*****************************************************************************
+ * @brief Create game
+ *
+ * Started game with seeded figure sequence and high score kept in memory
+ *
+ * @param seed Seed of figure sequence
+ * @param queueLength Number of upcoming figures: [1..TETRIS_QUEUE_MAX]
+ * @return TetrisGame_t* Handle of game
+ *****************************************************************************/
+TETRIS_API TetrisGame_t *createTetrisGame(uint32_t seed, int queueLength);
+
+/*****************************************************************************
+ * @brief Step game
+ *
+ * Apply action and advance logic clock, figure falls by gravity of current
+ *speed. Finished game stays over until TETRIS_ACTION_START
+ *
+ * @param game Handle of game
+ * @param action TETRIS_ACTION_* value, others are ignored
+ * @param ticks Number of ticks to advance clock by: 1000 per second
+ * @return bool True if game is over
+ *****************************************************************************/
+TETRIS_API bool stepTetrisGame(TetrisGame_t *game, int action,
+                               uint32_t ticks);
+
+/*****************************************************************************
+ * @brief Read field of game
+ *
+ * Visible field row by row with current figure: 0 for empty pixel or figure
+ *type + 1
+ *
+ * @param game Handle of game
+ * @param field Array of TETRIS_ROWS * TETRIS_COLS pixels to fill
+ *****************************************************************************/
+TETRIS_API void readTetrisField(const TetrisGame_t *game, uint8_t *field);
+
+/*****************************************************************************
+ * @brief Get score of game
+ *
+ * @param game Handle of game
+ * @return int Current score
+ *****************************************************************************/
+TETRIS_API int getTetrisScore(const TetrisGame_t *game);
+
+/*****************************************************************************
+ * @brief Destroy game
+ *
+ * @param game Handle of game or NULL
+ *****************************************************************************/
+TETRIS_API void destroyTetrisGame(TetrisGame_t *game);
+
+/*****************************************************************************
+ * @brief Create batched environments
+ *
+ * Games of the same rules stepped together, finished ones restart at once.
+ *Planes are owned by environments and stay at the same address until
+ *destroyTetrisVec
+ *
+ * @param count Number of games: at least 1
+ * @param seed Seed of the first game, next games get next seeds
+ * @param gravity Number of steps per gravity shift, 0 for no gravity
+ * @param queueLength Number of upcoming figures: [1..TETRIS_QUEUE_MAX]
+ * @return TetrisVec_t* Handle of environments
+ *****************************************************************************/
+TETRIS_API TetrisVec_t *createTetrisVec(int count, uint32_t seed, int gravity,
+                                        int queueLength);
+
+/*****************************************************************************
+ * @brief Step batched environments
+ *
+ * Apply action to every game: TETRIS_ACTION_LEFT, TETRIS_ACTION_RIGHT,
+ *TETRIS_ACTION_ROTATE and TETRIS_ACTION_DROP (hard drop), others wait.
+ *Nothing is allocated
+ *
+ * @param vec Handle of environments
+ * @param actions Array of count actions
+ * @param rewards Array of count score gains to fill or NULL
+ * @param dones Array of count flags of game over to fill or NULL
+ *****************************************************************************/
+TETRIS_API void stepTetrisVec(TetrisVec_t *vec, const uint8_t *actions,
+                              float *rewards, uint8_t *dones);
+
+/*****************************************************************************
+ * @brief Get planes of batched environments
+ *
+ * @param vec Handle of environments
+ * @return const uint8_t* Array of shape (count, TETRIS_PLANES_COUNT,
+ *TETRIS_ROWS, TETRIS_COLS) of 0 or 1
+ *****************************************************************************/
+TETRIS_API const uint8_t *getTetrisVecPlanes(const TetrisVec_t *vec);
+
+/*****************************************************************************
+ * @brief Get next planes of batched environments
+ *
+ * @param vec Handle of environments
+ * @return const uint8_t* Array of shape (count, TETRIS_QUEUE_MAX,
+ *TETRIS_FIGURES_COUNT): one-hot types of upcoming figures
+ *****************************************************************************/
+TETRIS_API const uint8_t *getTetrisVecNextPlanes(const TetrisVec_t *vec);
+
+/*****************************************************************************
+ * @brief Get score of game of batched environments
+ *
+ * @param vec Handle of environments
+ * @param index Index of game
+ * @return int Current score, 0 if there is no such game
+ *****************************************************************************/
+TETRIS_API int getTetrisVecScore(const TetrisVec_t *vec, int index);
+
+/*****************************************************************************
+ * @brief Destroy batched environments
+ *
+ * @param vec Handle of environments or NULL
+ *****************************************************************************/
+TETRIS_API void destroyTetrisVec(TetrisVec_t *vec);
+
+#endif  // CORE_H
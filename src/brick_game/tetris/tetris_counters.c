@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * @file tetris_counters.c
+ * @brief Source File with Hardware Performance Counters of Benchmarks
+ *****************************************************************************/
+
+// syscall of perf_event_open is not POSIX
+#define _DEFAULT_SOURCE
+
+#include "tetris_counters.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char *counterNames[COUNTERS_COUNT] = {
+    "cycles", "instructions", "l1d misses", "llc misses", "branch misses"};
+
+#ifdef __linux__
+static const struct {
+  unsigned type;
+  unsigned long long config;
+} counterEvents[COUNTERS_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                             PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                             PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+
+static int openCounter(Counter_t counter) {
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = counterEvents[counter].type;
+  attr.config = counterEvents[counter].config;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+void initializeCounters(Counters_t *counters) {
+  counters->error = 0;
+
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+#ifdef __linux__
+    counters->fds[i] = openCounter((Counter_t)i);
+#else
+    counters->fds[i] = -1;
+    errno = ENOSYS;
+#endif
+    if (counters->fds[i] < 0 && !counters->error) counters->error = errno;
+    counters->values[i] = 0;
+    counters->isCounted[i] = false;
+  }
+}
+
+void startCounters(Counters_t *counters) {
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+#ifdef __linux__
+    if (counters->fds[i] >= 0) {
+      ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    counters->isCounted[i] = false;
+  }
+}
+
+void stopCounters(Counters_t *counters) {
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+#ifdef __linux__
+    // Value, time enabled and time running of counter
+    unsigned long long data[3];
+
+    if (counters->fds[i] >= 0) {
+      ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      counters->isCounted[i] =
+          read(counters->fds[i], data, sizeof(data)) == sizeof(data) &&
+          data[2] > 0;
+    }
+
+    // Hardware multiplexed counter for a part of time, estimate the whole
+    if (counters->isCounted[i]) {
+      counters->values[i] =
+          data[2] < data[1]
+              ? (unsigned long long)((double)data[0] * data[1] / data[2])
+              : data[0];
+    }
+#else
+    counters->isCounted[i] = false;
+#endif
+  }
+}
+
+void printCounters(const Counters_t *counters, const CounterUnit_t *units,
+                   int unitsCount) {
+  bool isAny = false;
+
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+    if (counters->isCounted[i]) {
+      isAny = true;
+      printf("%s: %llu", counterNames[i], counters->values[i]);
+
+      for (int k = 0; k < unitsCount && k < COUNTER_UNITS_MAX; ++k) {
+        printf("%s%.1f/%s", k ? ", " : " (",
+               units[k].count > 0
+                   ? (double)counters->values[i] / units[k].count
+                   : 0.0,
+               units[k].name);
+      }
+      printf("%s\n", unitsCount > 0 ? ")" : "");
+    } else if (counters->fds[i] >= 0) {
+      printf("%s: not counted\n", counterNames[i]);
+    }
+  }
+
+  if (counters->isCounted[COUNTER_CYCLES] &&
+      counters->isCounted[COUNTER_INSTRUCTIONS] &&
+      counters->values[COUNTER_CYCLES] > 0) {
+    printf("ipc: %.2f\n", (double)counters->values[COUNTER_INSTRUCTIONS] /
+                              counters->values[COUNTER_CYCLES]);
+  }
+
+  if (counters->error) {
+    printf("counters%s unavailable: %s\n", isAny ? " partly" : "",
+           strerror(counters->error));
+  }
+}
+
+void removeCounters(Counters_t *counters) {
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+#ifdef __linux__
+    if (counters->fds[i] >= 0) close(counters->fds[i]);
+#endif
+    counters->fds[i] = -1;
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+/*****************************************************************************
+ * @file tetris_counters.h
+ * @brief Header File with Hardware Performance Counters of Benchmarks
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdbool.h>
+
+#define COUNTERS_COUNT 5
+#define COUNTER_UNITS_MAX 4
+
+/*****************************************************************************
+ * @brief Hardware counters
+ *****************************************************************************/
+typedef enum {
+  COUNTER_CYCLES = 0,
+  COUNTER_INSTRUCTIONS,
+  COUNTER_L1_MISSES,  // L1 data cache read misses
+  COUNTER_LLC_MISSES,
+  COUNTER_BRANCH_MISSES
+} Counter_t;
+
+/*****************************************************************************
+ * @brief Counters struct
+ *
+ * Linux perf_event_open counters of user space of the process and of threads
+ *it starts after initializeCounters. Counters the kernel or the hardware
+ *doesn't allow stay closed, other ones still count
+ *
+ * @param fds File descriptors of counters, -1 for closed ones
+ * @param values Counts between the last startCounters and stopCounters,
+ *scaled if hardware shared counter with other events
+ * @param isCounted Flags that values are valid
+ * @param error Errno of the first counter that couldn't be opened, 0 if all
+ *are opened
+ *****************************************************************************/
+typedef struct {
+  int fds[COUNTERS_COUNT];
+  unsigned long long values[COUNTERS_COUNT];
+  bool isCounted[COUNTERS_COUNT];
+  int error;
+} Counters_t;
+
+/*****************************************************************************
+ * @brief Unit of work to report counters by
+ *
+ * @param name Name of unit, e.g. "tick"
+ * @param count Number of units done between start and stop
+ *****************************************************************************/
+typedef struct {
+  const char *name;
+  double count;
+} CounterUnit_t;
+
+/*****************************************************************************
+ * @brief Initialize counters
+ *
+ * Open stopped counters, must be called before threads to count are started
+ *
+ * @param counters Pointer to struct of Counters_t
+ *****************************************************************************/
+void initializeCounters(Counters_t *counters);
+
+/*****************************************************************************
+ * @brief Start counters
+ *
+ * Reset and enable opened counters of process and of its started threads
+ *
+ * @param counters Pointer to struct of Counters_t
+ *****************************************************************************/
+void startCounters(Counters_t *counters);
+
+/*****************************************************************************
+ * @brief Stop counters
+ *
+ * Disable counters and read values, counts of threads are included only
+ *after threads have exited
+ *
+ * @param counters Pointer to struct of Counters_t
+ *****************************************************************************/
+void stopCounters(Counters_t *counters);
+
+/*****************************************************************************
+ * @brief Print counters
+ *
+ * Print every counter with its value per every unit, or why it is
+ *unavailable
+ *
+ * @param counters Pointer to struct of Counters_t
+ * @param units Units of work
+ * @param unitsCount Number of units: [0..COUNTER_UNITS_MAX]
+ *****************************************************************************/
+void printCounters(const Counters_t *counters, const CounterUnit_t *units,
+                   int unitsCount);
+
+/*****************************************************************************
+ * @brief Remove counters
+ *
+ * Close opened counters
+ *
+ * @param counters Pointer to struct of Counters_t
+ *****************************************************************************/
+void removeCounters(Counters_t *counters);
+
+#endif  // COUNTERS_H
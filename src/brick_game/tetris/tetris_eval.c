@@ -0,0 +1,320 @@
+/*****************************************************************************
+ * @file tetris_eval.c
+ * @brief Source File with Heuristic Evaluation of Boards
+ *
+ * Every feature is computed bit-parallel over row masks of playable columns,
+ *top to bottom, with seen holding columns that have a filled pixel at or
+ *above the current row. The same steps run on one board in scalar code and
+ *on 8 or 16 boards in SIMD kernels, one 16-bit lane per board
+ *****************************************************************************/
+
+#include "tetris_eval.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+const Weights_t defaultWeights = {{
+    -0.51f,  // FEATURE_HEIGHT
+    -3.60f,  // FEATURE_HOLES
+    -0.18f,  // FEATURE_BUMPINESS
+    -0.32f,  // FEATURE_ROW_TRANSITIONS
+    -0.93f,  // FEATURE_COL_TRANSITIONS
+    -0.34f,  // FEATURE_WELLS
+    0.76f    // FEATURE_LINES
+}};
+
+void getFeatures(const Board_t *board, int lines, Features_t *features) {
+  unsigned seen = 0, previous = 0;
+  unsigned depth[EVAL_DEPTH_BITS] = {0};
+  int height = 0, holes = 0, bumpiness = 0, rowTransitions = 0,
+      colTransitions = 0, wells = 0;
+
+  for (int row = 0; row < EVAL_ROWS; ++row) {
+    unsigned mask = (unsigned)board->rows[row] >> BORDER_SIZE & EVAL_MASK;
+
+    holes += __builtin_popcount(seen & ~mask);
+    seen |= mask;
+    height += __builtin_popcount(seen);
+    bumpiness += __builtin_popcount((seen ^ seen >> 1) & EVAL_MASK >> 1);
+
+    unsigned walled = mask << 1 | EVAL_WALLS;
+    rowTransitions +=
+        __builtin_popcount((walled ^ walled >> 1) & (EVAL_MASK << 1 | 1));
+    colTransitions += __builtin_popcount(mask ^ previous);
+    previous = mask;
+
+    // Open pixel between filled neighbours: bit-sliced depth counter of
+    // every column grows in wells and drops to 0 elsewhere
+    unsigned well = ~seen & walled & walled >> 2 & EVAL_MASK;
+    unsigned carry = well;
+    for (int bit = 0; bit < EVAL_DEPTH_BITS; ++bit) {
+      unsigned next = depth[bit] ^ carry;
+      carry &= depth[bit];
+      depth[bit] = next & well;
+      wells += __builtin_popcount(depth[bit]) << bit;
+    }
+  }
+
+  colTransitions += __builtin_popcount(previous ^ EVAL_MASK);
+
+  features->values[FEATURE_HEIGHT] = height;
+  features->values[FEATURE_HOLES] = holes;
+  features->values[FEATURE_BUMPINESS] = bumpiness;
+  features->values[FEATURE_ROW_TRANSITIONS] = rowTransitions;
+  features->values[FEATURE_COL_TRANSITIONS] = colTransitions;
+  features->values[FEATURE_WELLS] = wells;
+  features->values[FEATURE_LINES] = lines;
+}
+
+float getScore(const Features_t *features, const Weights_t *weights) {
+  float score = 0;
+
+  for (int feature = 0; feature < FEATURES_COUNT; ++feature) {
+    score += weights->values[feature] * (float)features->values[feature];
+  }
+
+  return score;
+}
+
+float evaluateBoard(const Board_t *board, int lines, const Weights_t *weights) {
+  Features_t features;
+  getFeatures(board, lines, &features);
+
+  return getScore(&features, weights);
+}
+
+void evaluateBoards(const Board_t *boards, const int *lines, int count,
+                    const Weights_t *weights, float *scores) {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2")) {
+    evaluateBoardsAvx2(boards, lines, count, weights, scores);
+  } else {
+    evaluateBoardsSse2(boards, lines, count, weights, scores);
+  }
+#else
+  evaluateBoardsScalar(boards, lines, count, weights, scores);
+#endif
+}
+
+void evaluateBoardsScalar(const Board_t *boards, const int *lines, int count,
+                          const Weights_t *weights, float *scores) {
+  for (int i = 0; i < count; ++i) {
+    scores[i] = evaluateBoard(&boards[i], lines[i], weights);
+  }
+}
+
+#if defined(__x86_64__)
+
+/*****************************************************************************
+ * @brief Transposed rows of boards
+ *
+ * Row masks of playable columns of up to 16 boards, one board per column, so
+ *a row of every board is loaded by one vector load
+ *****************************************************************************/
+typedef uint16_t EvalBlock_t[EVAL_ROWS][16];
+
+static void transposeBoards(const Board_t *boards, int count,
+                            EvalBlock_t block) {
+  for (int row = 0; row < EVAL_ROWS; ++row) {
+    for (int i = 0; i < 16; ++i) {
+      block[row][i] =
+          i < count
+              ? (uint16_t)(boards[i].rows[row] >> BORDER_SIZE & EVAL_MASK)
+              : 0;
+    }
+  }
+}
+
+static void scoreBlock(uint16_t sums[FEATURE_LINES][16],
+                       const int *lines, int count, const Weights_t *weights,
+                       float *scores) {
+  for (int i = 0; i < count; ++i) {
+    Features_t features;
+
+    for (int feature = 0; feature < FEATURE_LINES; ++feature) {
+      features.values[feature] = sums[feature][i];
+    }
+    features.values[FEATURE_LINES] = lines[i];
+
+    scores[i] = getScore(&features, weights);
+  }
+}
+
+static __m128i popcountSse2(__m128i x) {
+  x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1),
+                                     _mm_set1_epi16(0x5555)));
+  x = _mm_add_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)),
+                    _mm_and_si128(_mm_srli_epi16(x, 2),
+                                  _mm_set1_epi16(0x3333)));
+  x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)),
+                    _mm_set1_epi16(0x0F0F));
+
+  return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)),
+                       _mm_set1_epi16(0x1F));
+}
+
+void evaluateBoardsSse2(const Board_t *boards, const int *lines, int count,
+                        const Weights_t *weights, float *scores) {
+  const __m128i mask = _mm_set1_epi16(EVAL_MASK);
+  const __m128i walls = _mm_set1_epi16(EVAL_WALLS);
+  const __m128i pairs = _mm_set1_epi16(EVAL_MASK >> 1);
+  const __m128i walledPairs = _mm_set1_epi16(EVAL_MASK << 1 | 1);
+  EvalBlock_t block;
+
+  for (int first = 0; first < count; first += 8) {
+    int lanes = count - first < 8 ? count - first : 8;
+    transposeBoards(boards + first, lanes, block);
+
+    __m128i seen = _mm_setzero_si128(), previous = _mm_setzero_si128();
+    __m128i depth[EVAL_DEPTH_BITS];
+    __m128i sums[FEATURE_LINES];
+    for (int bit = 0; bit < EVAL_DEPTH_BITS; ++bit) {
+      depth[bit] = _mm_setzero_si128();
+    }
+    for (int feature = 0; feature < FEATURE_LINES; ++feature) {
+      sums[feature] = _mm_setzero_si128();
+    }
+
+    for (int row = 0; row < EVAL_ROWS; ++row) {
+      __m128i rowMask = _mm_loadu_si128((const __m128i *)block[row]);
+
+      sums[FEATURE_HOLES] = _mm_add_epi16(
+          sums[FEATURE_HOLES], popcountSse2(_mm_andnot_si128(rowMask, seen)));
+      seen = _mm_or_si128(seen, rowMask);
+      sums[FEATURE_HEIGHT] =
+          _mm_add_epi16(sums[FEATURE_HEIGHT], popcountSse2(seen));
+      sums[FEATURE_BUMPINESS] = _mm_add_epi16(
+          sums[FEATURE_BUMPINESS],
+          popcountSse2(_mm_and_si128(
+              _mm_xor_si128(seen, _mm_srli_epi16(seen, 1)), pairs)));
+
+      __m128i walled = _mm_or_si128(_mm_slli_epi16(rowMask, 1), walls);
+      sums[FEATURE_ROW_TRANSITIONS] = _mm_add_epi16(
+          sums[FEATURE_ROW_TRANSITIONS],
+          popcountSse2(_mm_and_si128(
+              _mm_xor_si128(walled, _mm_srli_epi16(walled, 1)), walledPairs)));
+      sums[FEATURE_COL_TRANSITIONS] =
+          _mm_add_epi16(sums[FEATURE_COL_TRANSITIONS],
+                        popcountSse2(_mm_xor_si128(rowMask, previous)));
+      previous = rowMask;
+
+      __m128i well = _mm_andnot_si128(
+          seen,
+          _mm_and_si128(_mm_and_si128(walled, _mm_srli_epi16(walled, 2)),
+                        mask));
+      __m128i carry = well;
+      for (int bit = 0; bit < EVAL_DEPTH_BITS; ++bit) {
+        __m128i next = _mm_xor_si128(depth[bit], carry);
+        carry = _mm_and_si128(carry, depth[bit]);
+        depth[bit] = _mm_and_si128(next, well);
+        sums[FEATURE_WELLS] = _mm_add_epi16(
+            sums[FEATURE_WELLS],
+            _mm_sll_epi16(popcountSse2(depth[bit]), _mm_cvtsi32_si128(bit)));
+      }
+    }
+
+    sums[FEATURE_COL_TRANSITIONS] =
+        _mm_add_epi16(sums[FEATURE_COL_TRANSITIONS],
+                      popcountSse2(_mm_xor_si128(previous, mask)));
+
+    uint16_t values[FEATURE_LINES][16];
+    for (int feature = 0; feature < FEATURE_LINES; ++feature) {
+      _mm_storeu_si128((__m128i *)values[feature], sums[feature]);
+    }
+
+    scoreBlock(values, lines + first, lanes, weights, scores + first);
+  }
+}
+
+__attribute__((target("avx2"))) static __m256i popcountAvx2(__m256i x) {
+  x = _mm256_sub_epi16(x, _mm256_and_si256(_mm256_srli_epi16(x, 1),
+                                           _mm256_set1_epi16(0x5555)));
+  x = _mm256_add_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x3333)),
+                       _mm256_and_si256(_mm256_srli_epi16(x, 2),
+                                        _mm256_set1_epi16(0x3333)));
+  x = _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 4)),
+                       _mm256_set1_epi16(0x0F0F));
+
+  return _mm256_and_si256(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)),
+                          _mm256_set1_epi16(0x1F));
+}
+
+__attribute__((target("avx2"))) void evaluateBoardsAvx2(
+    const Board_t *boards, const int *lines, int count,
+    const Weights_t *weights, float *scores) {
+  const __m256i mask = _mm256_set1_epi16(EVAL_MASK);
+  const __m256i walls = _mm256_set1_epi16(EVAL_WALLS);
+  const __m256i pairs = _mm256_set1_epi16(EVAL_MASK >> 1);
+  const __m256i walledPairs = _mm256_set1_epi16(EVAL_MASK << 1 | 1);
+  EvalBlock_t block;
+
+  for (int first = 0; first < count; first += 16) {
+    int lanes = count - first < 16 ? count - first : 16;
+    transposeBoards(boards + first, lanes, block);
+
+    __m256i seen = _mm256_setzero_si256(), previous = _mm256_setzero_si256();
+    __m256i depth[EVAL_DEPTH_BITS];
+    __m256i sums[FEATURE_LINES];
+    for (int bit = 0; bit < EVAL_DEPTH_BITS; ++bit) {
+      depth[bit] = _mm256_setzero_si256();
+    }
+    for (int feature = 0; feature < FEATURE_LINES; ++feature) {
+      sums[feature] = _mm256_setzero_si256();
+    }
+
+    for (int row = 0; row < EVAL_ROWS; ++row) {
+      __m256i rowMask = _mm256_loadu_si256((const __m256i *)block[row]);
+
+      sums[FEATURE_HOLES] =
+          _mm256_add_epi16(sums[FEATURE_HOLES],
+                           popcountAvx2(_mm256_andnot_si256(rowMask, seen)));
+      seen = _mm256_or_si256(seen, rowMask);
+      sums[FEATURE_HEIGHT] =
+          _mm256_add_epi16(sums[FEATURE_HEIGHT], popcountAvx2(seen));
+      sums[FEATURE_BUMPINESS] = _mm256_add_epi16(
+          sums[FEATURE_BUMPINESS],
+          popcountAvx2(_mm256_and_si256(
+              _mm256_xor_si256(seen, _mm256_srli_epi16(seen, 1)), pairs)));
+
+      __m256i walled = _mm256_or_si256(_mm256_slli_epi16(rowMask, 1), walls);
+      sums[FEATURE_ROW_TRANSITIONS] = _mm256_add_epi16(
+          sums[FEATURE_ROW_TRANSITIONS],
+          popcountAvx2(_mm256_and_si256(
+              _mm256_xor_si256(walled, _mm256_srli_epi16(walled, 1)),
+              walledPairs)));
+      sums[FEATURE_COL_TRANSITIONS] =
+          _mm256_add_epi16(sums[FEATURE_COL_TRANSITIONS],
+                           popcountAvx2(_mm256_xor_si256(rowMask, previous)));
+      previous = rowMask;
+
+      __m256i well = _mm256_andnot_si256(
+          seen, _mm256_and_si256(
+                    _mm256_and_si256(walled, _mm256_srli_epi16(walled, 2)),
+                    mask));
+      __m256i carry = well;
+      for (int bit = 0; bit < EVAL_DEPTH_BITS; ++bit) {
+        __m256i next = _mm256_xor_si256(depth[bit], carry);
+        carry = _mm256_and_si256(carry, depth[bit]);
+        depth[bit] = _mm256_and_si256(next, well);
+        sums[FEATURE_WELLS] = _mm256_add_epi16(
+            sums[FEATURE_WELLS],
+            _mm256_sll_epi16(popcountAvx2(depth[bit]),
+                             _mm_cvtsi32_si128(bit)));
+      }
+    }
+
+    sums[FEATURE_COL_TRANSITIONS] =
+        _mm256_add_epi16(sums[FEATURE_COL_TRANSITIONS],
+                         popcountAvx2(_mm256_xor_si256(previous, mask)));
+
+    uint16_t values[FEATURE_LINES][16];
+    for (int feature = 0; feature < FEATURE_LINES; ++feature) {
+      _mm256_storeu_si256((__m256i *)values[feature], sums[feature]);
+    }
+
+    scoreBlock(values, lines + first, lanes, weights, scores + first);
+  }
+}
+
+#endif
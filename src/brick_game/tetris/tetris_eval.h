@@ -0,0 +1,130 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+/*****************************************************************************
+ * @file tetris_eval.h
+ * @brief Header File with Heuristic Evaluation of Boards
+ *****************************************************************************/
+
+#include "tetris_board.h"
+
+#define EVAL_ROWS (FIELD_HEIGHT - BORDER_SIZE)  // Rows above floor
+#define EVAL_COLS (FIELD_WIDTH - BORDER_SIZE * 2)
+#define EVAL_MASK ((1u << EVAL_COLS) - 1)
+#define EVAL_WALLS (1u | 1u << (EVAL_COLS + 1))
+#define EVAL_DEPTH_BITS 5  // Bits of well depth counter: depth < 32
+
+/*****************************************************************************
+ * @brief Board features
+ *
+ * Features of board used by evaluation, used as index of feature values
+ *****************************************************************************/
+typedef enum {
+  FEATURE_HEIGHT = 0,       // Sum of column heights
+  FEATURE_HOLES,            // Empty pixels under filled ones
+  FEATURE_BUMPINESS,        // Sum of height differences of adjacent columns
+  FEATURE_ROW_TRANSITIONS,  // Empty/filled changes along rows with walls
+  FEATURE_COL_TRANSITIONS,  // Empty/filled changes along columns with floor
+  FEATURE_WELLS,            // Sum of 1 + 2 + ... + depth of every well
+  FEATURE_LINES,            // Rows removed by the last placement
+  FEATURES_COUNT
+} Feature_t;
+
+/*****************************************************************************
+ * @brief Feature values struct
+ *
+ * @param values Value of every feature indexed by Feature_t
+ *****************************************************************************/
+typedef struct {
+  int values[FEATURES_COUNT];
+} Features_t;
+
+/*****************************************************************************
+ * @brief Evaluation weights struct
+ *
+ * @param values Weight of every feature indexed by Feature_t
+ *****************************************************************************/
+typedef struct {
+  float values[FEATURES_COUNT];
+} Weights_t;
+
+/*****************************************************************************
+ * @brief Default weights
+ *
+ * Weights that keep the stack low and flat without holes
+ *****************************************************************************/
+extern const Weights_t defaultWeights;
+
+/*****************************************************************************
+ * @brief Get features of board
+ *
+ * Compute all features over row masks of playable columns, one row at a time
+ *
+ * @param board Pointer to struct of Board_t
+ * @param lines Rows removed by the last placement
+ * @param features Pointer to struct of Features_t to fill
+ *****************************************************************************/
+void getFeatures(const Board_t *board, int lines, Features_t *features);
+
+/*****************************************************************************
+ * @brief Get score of features
+ *
+ * @param features Pointer to struct of Features_t
+ * @param weights Pointer to struct of Weights_t
+ * @return float Weighted sum of features, higher is better
+ *****************************************************************************/
+float getScore(const Features_t *features, const Weights_t *weights);
+
+/*****************************************************************************
+ * @brief Evaluate board
+ *
+ * @param board Pointer to struct of Board_t
+ * @param lines Rows removed by the last placement
+ * @param weights Pointer to struct of Weights_t
+ * @return float Score of board, higher is better
+ *****************************************************************************/
+float evaluateBoard(const Board_t *board, int lines, const Weights_t *weights);
+
+/*****************************************************************************
+ * @brief Evaluate boards
+ *
+ * Score many boards at once with the widest SIMD kernel supported by CPU:
+ *AVX2, SSE2 or scalar. Scores are equal to evaluateBoard
+ *
+ * @param boards Array of boards
+ * @param lines Array of rows removed by the last placement of every board
+ * @param count Number of boards
+ * @param weights Pointer to struct of Weights_t
+ * @param scores Array of count scores to fill
+ *****************************************************************************/
+void evaluateBoards(const Board_t *boards, const int *lines, int count,
+                    const Weights_t *weights, float *scores);
+
+/*****************************************************************************
+ * @brief Evaluate boards one by one
+ *
+ * Scalar fallback of evaluateBoards
+ *****************************************************************************/
+void evaluateBoardsScalar(const Board_t *boards, const int *lines, int count,
+                          const Weights_t *weights, float *scores);
+
+#if defined(__x86_64__)
+/*****************************************************************************
+ * @brief Evaluate boards with SSE2
+ *
+ * SSE2 kernel of evaluateBoards: 8 boards at once, one 16-bit lane per board
+ *****************************************************************************/
+void evaluateBoardsSse2(const Board_t *boards, const int *lines, int count,
+                        const Weights_t *weights, float *scores);
+
+/*****************************************************************************
+ * @brief Evaluate boards with AVX2
+ *
+ * AVX2 kernel of evaluateBoards: 16 boards at once, one 16-bit lane per board.
+ *Must be called only if CPU supports AVX2
+ *****************************************************************************/
+void evaluateBoardsAvx2(const Board_t *boards, const int *lines, int count,
+                        const Weights_t *weights, float *scores);
+#endif
+
+#endif  // EVAL_H
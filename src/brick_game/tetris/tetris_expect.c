@@ -0,0 +1,213 @@
+/*****************************************************************************
+ * @file tetris_expect.c
+ * @brief Source File with Expectimax Search over Distribution of Figures
+ *****************************************************************************/
+
+#include "tetris_expect.h"
+
+#include <string.h>
+
+static const int noLines[PLACEMENTS_MAX];
+
+static long long getExpectTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static uint64_t getDepthKey(int depth) {
+  return (uint64_t)depth * EXPECT_DEPTH_KEY;
+}
+
+static float unpackValue(uint64_t data) {
+  uint32_t bits = (uint32_t)data;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+
+  return value;
+}
+
+static uint64_t packValue(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  return bits;
+}
+
+// Fill scratch of ply with placements of figure and their values
+static int expandNode(Expectimax_t *expect, const Board_t *board,
+                      uint64_t hash, const Figure_t *figure, int ply) {
+  ExpectScratch_t *scratch = expect->scratch[ply];
+  float linesWeight = expect->weights.values[FEATURE_LINES];
+  int count = generatePlacements(board, figure, scratch->placements);
+
+  for (int j = 0; j < count; ++j) {
+    const Placement_t *placement = &scratch->placements[j];
+    const Piece_t *piece = getPiece(figure->type, placement->rotation);
+
+    scratch->boards[j] = *board;
+    scratch->lines[j] =
+        placePiece(&scratch->boards[j], piece, placement->x, placement->y);
+    scratch->hashes[j] =
+        scratch->lines[j] ? getBoardHash(&scratch->boards[j])
+                          : hash ^ getPieceHash(piece, placement->x,
+                                                placement->y);
+  }
+
+  if (ply + 1 == expect->searchDepth) {
+    evaluateBoards(scratch->boards, noLines, count, &expect->weights,
+                   scratch->scores);
+
+    for (int j = 0; j < count; ++j) {
+      scratch->scores[j] += linesWeight * scratch->lines[j];
+    }
+  } else {
+    for (int j = 0; j < count && !expect->isTimeout; ++j) {
+      scratch->scores[j] =
+          linesWeight * scratch->lines[j] +
+          getChanceValue(expect, &scratch->boards[j], scratch->hashes[j],
+                         ply + 1);
+    }
+  }
+
+  return count;
+}
+
+void initializeExpectimax(Expectimax_t *expect, int depth,
+                          const Weights_t *weights, int tableBits) {
+  if (depth < 1) depth = 1;
+  if (depth > EXPECT_DEPTH_MAX) depth = EXPECT_DEPTH_MAX;
+
+  expect->depth = depth;
+  expect->weights = weights ? *weights : defaultWeights;
+  expect->typesCount = 0;
+  expect->completed = 0;
+  initializeHashTable(&expect->table, tableBits);
+
+  for (int i = 0; i < EXPECT_DEPTH_MAX; ++i) {
+    expect->scratch[i] = i < depth ? malloc(sizeof(ExpectScratch_t)) : NULL;
+
+    if (i < depth && NULL == expect->scratch[i]) {
+      printf("\nNot enough memory...\n");
+      exit(1);
+    }
+  }
+}
+
+int analyzeExpectimax(Expectimax_t *expect, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placements, float *values) {
+  ExpectScratch_t *scratch = expect->scratch[0];
+  uint64_t hash = getBoardHash(board);
+  int count = 0;
+
+  if (typesCount > EXPECT_DEPTH_MAX) typesCount = EXPECT_DEPTH_MAX;
+  memcpy(expect->types, types, sizeof(types[0]) * (size_t)typesCount);
+  expect->typesCount = typesCount;
+  expect->deadline = deadline;
+  expect->isTimeout = false;
+  expect->completed = 0;
+
+  // Depth 1 has no chance nodes and is never stopped by deadline
+  for (int depth = 1; depth <= expect->depth && !expect->isTimeout &&
+                      (depth == 1 || getExpectTime() < deadline);
+       ++depth) {
+    expect->searchDepth = depth;
+    int expanded = expandNode(expect, board, hash, figure, 0);
+
+    if (!expect->isTimeout) {
+      count = expanded;
+      memcpy(placements, scratch->placements,
+             sizeof(placements[0]) * (size_t)count);
+      memcpy(values, scratch->scores, sizeof(values[0]) * (size_t)count);
+      expect->completed = depth;
+    }
+  }
+
+  return count;
+}
+
+bool chooseExpectimax(Expectimax_t *expect, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placement) {
+  Placement_t placements[PLACEMENTS_MAX];
+  float values[PLACEMENTS_MAX];
+  int count = analyzeExpectimax(expect, board, figure, types, typesCount,
+                                deadline, placements, values);
+  int best = 0;
+
+  for (int i = 1; i < count; ++i) {
+    if (values[i] > values[best]) best = i;
+  }
+
+  if (count > 0) *placement = placements[best];
+
+  return count > 0;
+}
+
+float getMaxValue(Expectimax_t *expect, const Board_t *board, uint64_t hash,
+                  int type, int ply) {
+  // Node without known types below it depends only on board, type and depth
+  bool isMemo = ply >= expect->typesCount;
+  uint64_t key = hash ^ getTypeKey(type) ^
+                 getDepthKey(expect->searchDepth - ply);
+  uint64_t data;
+  float value = EXPECT_LOSS;
+  Figure_t figure;
+
+  if (isMemo && probeHash(&expect->table, key, &data)) {
+    value = unpackValue(data);
+  } else if (getExpectTime() >= expect->deadline) {
+    expect->isTimeout = true;
+  } else if (spawnBoardFigure(board, type, &figure)) {
+    int count = expandNode(expect, board, hash, &figure, ply);
+    const float *scores = expect->scratch[ply]->scores;
+
+    for (int j = 0; j < count; ++j) {
+      if (scores[j] > value) value = scores[j];
+    }
+
+    if (isMemo && !expect->isTimeout) {
+      storeHash(&expect->table, key, packValue(value));
+    }
+  }
+
+  return value;
+}
+
+float getChanceValue(Expectimax_t *expect, const Board_t *board,
+                     uint64_t hash, int ply) {
+  uint64_t key = hash ^ getDepthKey(expect->searchDepth - ply) ^
+                 EXPECT_CHANCE_KEY;
+  uint64_t data;
+  float value = 0;
+
+  if (ply <= expect->typesCount) {
+    value = getMaxValue(expect, board, hash, expect->types[ply - 1], ply);
+  } else if (probeHash(&expect->table, key, &data)) {
+    value = unpackValue(data);
+  } else {
+    for (int type = 0; type < FIGURES_COUNT && !expect->isTimeout; ++type) {
+      value += getMaxValue(expect, board, hash, type, ply);
+    }
+    value /= FIGURES_COUNT;
+
+    if (!expect->isTimeout) {
+      storeHash(&expect->table, key, packValue(value));
+    }
+  }
+
+  return value;
+}
+
+void removeExpectimax(Expectimax_t *expect) {
+  for (int i = 0; i < EXPECT_DEPTH_MAX; ++i) {
+    free(expect->scratch[i]);
+    expect->scratch[i] = NULL;
+  }
+
+  removeHashTable(&expect->table);
+}
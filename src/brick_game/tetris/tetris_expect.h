@@ -0,0 +1,168 @@
+#ifndef EXPECT_H
+#define EXPECT_H
+
+/*****************************************************************************
+ * @file tetris_expect.h
+ * @brief Header File with Expectimax Search over Distribution of Figures
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tetris_board.h"
+#include "tetris_eval.h"
+#include "tetris_hash.h"
+#include "tetris_logic.h"
+
+#define EXPECT_DEPTH 3
+#define EXPECT_DEPTH_MAX 6
+#define EXPECT_LOSS -1000.0f  // value of board where figure can't be placed
+#define EXPECT_DEPTH_KEY 0xD6E8FEB86659FD93ull
+#define EXPECT_CHANCE_KEY 0xA0761D6478BD642Full
+
+/*****************************************************************************
+ * @brief Expectimax scratch struct
+ *
+ * Children of one node of a ply
+ *
+ * @param placements Placements of figure
+ * @param boards Boards after placements
+ * @param hashes Hashes of boards
+ * @param lines Rows removed by placements
+ * @param scores Evaluations of boards without removed rows
+ *****************************************************************************/
+typedef struct {
+  Placement_t placements[PLACEMENTS_MAX];
+  Board_t boards[PLACEMENTS_MAX];
+  uint64_t hashes[PLACEMENTS_MAX];
+  int lines[PLACEMENTS_MAX];
+  float scores[PLACEMENTS_MAX];
+} ExpectScratch_t;
+
+/*****************************************************************************
+ * @brief Expectimax struct
+ *
+ * Search of expected evaluation: figures of known types are placed at their
+ *best, beyond them every of FIGURES_COUNT types is equally likely as
+ *generateRandomFigure draws them uniformly. Values of nodes without known
+ *types below them depend only on board, type and depth and are memoized in
+ *transposition table kept between searches
+ *
+ * @param depth Maximum number of plies including current figure:
+ *[1..EXPECT_DEPTH_MAX]
+ * @param weights Weights of evaluation, table must be cleared if changed
+ * @param table Transposition table of node values
+ * @param scratch Children of nodes of every ply
+ * @param types Known types of search
+ * @param typesCount Number of known types
+ * @param searchDepth Depth being searched
+ * @param deadline Monotonic time in ns to stop search
+ * @param isTimeout Flag that depth being searched has passed deadline
+ * @param completed Number of plies of the last analysis
+ *****************************************************************************/
+typedef struct {
+  int depth;
+  Weights_t weights;
+  HashTable_t table;
+  ExpectScratch_t *scratch[EXPECT_DEPTH_MAX];
+  int types[EXPECT_DEPTH_MAX];
+  int typesCount;
+  int searchDepth;
+  long long deadline;
+  bool isTimeout;
+  int completed;
+} Expectimax_t;
+
+/*****************************************************************************
+ * @brief Initialize expectimax
+ *
+ * Allocate scratch of plies and transposition table
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ * @param depth Maximum number of plies: [1..EXPECT_DEPTH_MAX]
+ * @param weights Pointer to weights of evaluation or NULL for defaultWeights
+ * @param tableBits Size of transposition table: 1 << bits entries
+ *****************************************************************************/
+void initializeExpectimax(Expectimax_t *expect, int depth,
+                          const Weights_t *weights, int tableBits);
+
+/*****************************************************************************
+ * @brief Analyze expectimax
+ *
+ * Get expected score of every placement of current figure. Depths are
+ *searched one by one until depth of expect or deadline, depth 1 is always
+ *searched and values of the deepest full depth are returned
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param types Known types of upcoming figures: typeNext and queue
+ * @param typesCount Number of known types
+ * @param deadline Monotonic time in ns to stop search
+ * @param placements Placements of current figure to fill
+ * @param values Expected scores of placements to fill
+ * @return int Number of placements
+ *****************************************************************************/
+int analyzeExpectimax(Expectimax_t *expect, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placements, float *values);
+
+/*****************************************************************************
+ * @brief Choose expectimax placement
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param types Known types of upcoming figures
+ * @param typesCount Number of known types
+ * @param deadline Monotonic time in ns to stop search
+ * @param placement Pointer to placement with the best expected score to fill
+ * @return bool False if figure has no placements
+ *****************************************************************************/
+bool chooseExpectimax(Expectimax_t *expect, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placement);
+
+/*****************************************************************************
+ * @brief Get value of max node
+ *
+ * Best value of placements of figure of type on board
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ * @param board Pointer to board
+ * @param hash Hash of board
+ * @param type Type of figure
+ * @param ply Ply of figure, 0 for current figure
+ * @return float Value of node
+ *****************************************************************************/
+float getMaxValue(Expectimax_t *expect, const Board_t *board, uint64_t hash,
+                  int type, int ply);
+
+/*****************************************************************************
+ * @brief Get value of board
+ *
+ * Value of board before figure of ply: max node of known type or mean of max
+ *nodes of all types
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ * @param board Pointer to board
+ * @param hash Hash of board
+ * @param ply Ply of the next figure
+ * @return float Value of board
+ *****************************************************************************/
+float getChanceValue(Expectimax_t *expect, const Board_t *board,
+                     uint64_t hash, int ply);
+
+/*****************************************************************************
+ * @brief Remove expectimax
+ *
+ * Clear allocated memory
+ *
+ * @param expect Pointer to struct of Expectimax_t
+ *****************************************************************************/
+void removeExpectimax(Expectimax_t *expect);
+
+#endif  // EXPECT_H
@@ -0,0 +1,146 @@
+/*****************************************************************************
+ * @file tetris_hash.c
+ * @brief Source File with Zobrist Hashing and Transposition Table
+ *****************************************************************************/
+
+#include "tetris_hash.h"
+
+#include <pthread.h>
+
+static uint64_t cellKeys[FIELD_HEIGHT][FIELD_WIDTH];
+static uint64_t typeKeys[FIGURES_COUNT];
+static pthread_once_t keysOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t getNextKey(uint64_t *state) {
+  // splitmix64
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+  return z ^ (z >> 31);
+}
+
+void initializeKeys(void) {
+  uint64_t state = HASH_SEED;
+
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    for (int col = 0; col < FIELD_WIDTH; ++col) {
+      bool isPlayable = row < FIELD_HEIGHT - BORDER_SIZE &&
+                        col >= BORDER_SIZE && col < FIELD_WIDTH - BORDER_SIZE;
+      cellKeys[row][col] = isPlayable ? getNextKey(&state) : 0;
+    }
+  }
+
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    typeKeys[type] = getNextKey(&state);
+  }
+}
+
+uint64_t getCellKey(int row, int col) {
+  pthread_once(&keysOnce, initializeKeys);
+
+  return cellKeys[row][col];
+}
+
+uint64_t getTypeKey(int type) {
+  pthread_once(&keysOnce, initializeKeys);
+
+  return typeKeys[type];
+}
+
+uint64_t getFieldHash(int **field) {
+  uint64_t hash = 0;
+  pthread_once(&keysOnce, initializeKeys);
+
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    for (int col = 0; col < FIELD_WIDTH; ++col) {
+      if (field[row][col]) hash ^= cellKeys[row][col];
+    }
+  }
+
+  return hash;
+}
+
+uint64_t getGameHash(const GameParameters_t *parameters) {
+  Board_t board;
+  initializeBoard(&board, parameters->data->field, parameters->figure);
+
+  return getBoardHash(&board) ^ getTypeKey(parameters->figure->type);
+}
+
+uint64_t getBoardHash(const Board_t *board) {
+  uint64_t hash = 0;
+  pthread_once(&keysOnce, initializeKeys);
+
+  for (int row = 0; row < FIELD_HEIGHT - BORDER_SIZE; ++row) {
+    unsigned bits = board->rows[row] & ROW_FULL;
+
+    while (bits) {
+      hash ^= cellKeys[row][__builtin_ctz(bits)];
+      bits &= bits - 1;
+    }
+  }
+
+  return hash;
+}
+
+uint64_t getPieceHash(const Piece_t *piece, int x, int y) {
+  uint64_t hash = 0;
+  pthread_once(&keysOnce, initializeKeys);
+
+  for (int k = 0; k < piece->height; ++k) {
+    unsigned bits = piece->rows[k];
+
+    while (bits) {
+      hash ^= cellKeys[y + piece->top + k][x + piece->left +
+                                           __builtin_ctz(bits)];
+      bits &= bits - 1;
+    }
+  }
+
+  return hash;
+}
+
+void initializeHashTable(HashTable_t *table, int bits) {
+  table->mask = (1ull << bits) - 1;
+  table->entries = malloc(sizeof(HashEntry_t) * (size_t)(table->mask + 1));
+
+  if (NULL == table->entries) {
+    printf("\nNot enough memory...\n");
+    exit(1);
+  }
+
+  clearHashTable(table);
+}
+
+void clearHashTable(HashTable_t *table) {
+  for (uint64_t i = 0; i <= table->mask; ++i) {
+    atomic_init(&table->entries[i].check, 0);
+    atomic_init(&table->entries[i].data, 0);
+  }
+}
+
+void storeHash(HashTable_t *table, uint64_t key, uint64_t data) {
+  HashEntry_t *entry = &table->entries[key & table->mask];
+
+  atomic_store_explicit(&entry->check, key ^ data ^ HASH_SEED,
+                        memory_order_relaxed);
+  atomic_store_explicit(&entry->data, data, memory_order_relaxed);
+}
+
+bool probeHash(HashTable_t *table, uint64_t key, uint64_t *data) {
+  HashEntry_t *entry = &table->entries[key & table->mask];
+  uint64_t check = atomic_load_explicit(&entry->check, memory_order_relaxed);
+  uint64_t stored = atomic_load_explicit(&entry->data, memory_order_relaxed);
+  bool isFound = (check ^ stored ^ HASH_SEED) == key;
+
+  if (isFound) *data = stored;
+
+  return isFound;
+}
+
+void removeHashTable(HashTable_t *table) {
+  free(table->entries);
+  table->entries = NULL;
+  table->mask = 0;
+}
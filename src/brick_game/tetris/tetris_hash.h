@@ -0,0 +1,157 @@
+#ifndef HASH_H
+#define HASH_H
+
+/*****************************************************************************
+ * @file tetris_hash.h
+ * @brief Header File with Zobrist Hashing and Transposition Table
+ *****************************************************************************/
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "tetris_board.h"
+
+#define HASH_SEED 0x9E3779B97F4A7C15ull
+#define HASH_TABLE_BITS 16  // entries of default table: 1 << bits
+
+/*****************************************************************************
+ * @brief Hash entry struct
+ *
+ * One slot of transposition table. Key is stored xored with data, so entry
+ *torn by concurrent writers never matches its key and no lock is needed. Key
+ *is also xored with HASH_SEED, so empty slot doesn't match key 0 of empty
+ *board
+ *
+ * @param check Key xor data xor HASH_SEED
+ * @param data Stored data
+ *****************************************************************************/
+typedef struct {
+  _Atomic uint64_t check;
+  _Atomic uint64_t data;
+} HashEntry_t;
+
+/*****************************************************************************
+ * @brief Transposition table struct
+ *
+ * Fixed-size table shared by threads without locks. Every key has one slot,
+ *new data always replaces old one
+ *
+ * @param entries Slots of table
+ * @param mask Number of slots - 1
+ *****************************************************************************/
+typedef struct {
+  HashEntry_t *entries;
+  uint64_t mask;
+} HashTable_t;
+
+/*****************************************************************************
+ * @brief Initialize Zobrist keys
+ *
+ * Fill keys of field pixels and figure types from fixed seed, so hashes are
+ *the same in every run. Called once by the first function reading keys
+ *****************************************************************************/
+void initializeKeys(void);
+
+/*****************************************************************************
+ * @brief Get key of pixel
+ *
+ * @param row Row of field
+ * @param col Col of field
+ * @return uint64_t Key of pixel, 0 for borders
+ *****************************************************************************/
+uint64_t getCellKey(int row, int col);
+
+/*****************************************************************************
+ * @brief Get key of figure type
+ *
+ * @param type Figure type number in figures array
+ * @return uint64_t Key of figure type
+ *****************************************************************************/
+uint64_t getTypeKey(int type);
+
+/*****************************************************************************
+ * @brief Get hash of field
+ *
+ * Compute hash of filled playable pixels from scratch
+ *
+ * @param field Game field with borders
+ * @return uint64_t Hash of field
+ *****************************************************************************/
+uint64_t getFieldHash(int **field);
+
+/*****************************************************************************
+ * @brief Get hash of game
+ *
+ * Compute hash of locked pixels with the keys of getBoardHash, combined with
+ *type of falling figure. Game must be started
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @return uint64_t Hash of game
+ *****************************************************************************/
+uint64_t getGameHash(const GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Get hash of board
+ *
+ * @param board Pointer to struct of Board_t
+ * @return uint64_t Hash of board, equal to getFieldHash of the same field
+ *****************************************************************************/
+uint64_t getBoardHash(const Board_t *board);
+
+/*****************************************************************************
+ * @brief Get hash of piece
+ *
+ * @param piece Pointer to struct of Piece_t
+ * @param x X coordinate of figure center
+ * @param y Y coordinate of figure center
+ * @return uint64_t Hash of piece pixels, xor it to add or remove piece
+ *****************************************************************************/
+uint64_t getPieceHash(const Piece_t *piece, int x, int y);
+
+/*****************************************************************************
+ * @brief Initialize transposition table
+ *
+ * @param table Pointer to struct of HashTable_t
+ * @param bits Size of table: 1 << bits entries
+ *****************************************************************************/
+void initializeHashTable(HashTable_t *table, int bits);
+
+/*****************************************************************************
+ * @brief Clear transposition table
+ *
+ * Forget all entries, e.g. after weights of evaluation are changed. Must not
+ *be called while table is used by other threads
+ *
+ * @param table Pointer to struct of HashTable_t
+ *****************************************************************************/
+void clearHashTable(HashTable_t *table);
+
+/*****************************************************************************
+ * @brief Store data
+ *
+ * @param table Pointer to struct of HashTable_t
+ * @param key Hash of position
+ * @param data Data of position
+ *****************************************************************************/
+void storeHash(HashTable_t *table, uint64_t key, uint64_t data);
+
+/*****************************************************************************
+ * @brief Probe data
+ *
+ * @param table Pointer to struct of HashTable_t
+ * @param key Hash of position
+ * @param data Pointer to data to fill
+ * @return bool False if there is no data of position
+ *****************************************************************************/
+bool probeHash(HashTable_t *table, uint64_t key, uint64_t *data);
+
+/*****************************************************************************
+ * @brief Remove transposition table
+ *
+ * Clear allocated memory
+ *
+ * @param table Pointer to struct of HashTable_t
+ *****************************************************************************/
+void removeHashTable(HashTable_t *table);
+
+#endif  // HASH_H
@@ -5,16 +5,22 @@
 
 #include "tetris_logic.h"
 
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tetris_trace.h"
+
 /*****************************************************************************
  * @brief Finite state machine table
  *
  * Finite state machine table
  *****************************************************************************/
 funcPointer fsmTable[STATES_COUNT][SIGNALS_COUNT] = {
-    {startGame, NULL, removeParameters, NULL, NULL, NULL, NULL, NULL},  // START
-    {NULL, pauseGame, removeParameters, moveLeft, moveRight, NULL, moveDown,
+    {startGame, NULL, terminateGame, NULL, NULL, NULL, NULL, NULL},  // START
+    {NULL, pauseGame, terminateGame, moveLeft, moveRight, NULL, moveDown,
      rotateFigure},  // GAME
-    {startGame, NULL, removeParameters, NULL, NULL, NULL, NULL,
+    {startGame, NULL, terminateGame, NULL, NULL, NULL, NULL,
      NULL}  // GAME_OVER
 };
 
@@ -34,6 +40,11 @@ int figures[FIGURES_COUNT][8] = {
 };
 
 void initializeParameters(GameParameters_t *parameters) {
+  initializeParametersPath(parameters, DATA_PATH);
+}
+
+void initializeParametersPath(GameParameters_t *parameters,
+                              const char *dataPath) {
   parameters->data->field = allocate2DArray(FIELD_HEIGHT, FIELD_WIDTH);
   parameters->data->next = allocate2DArray(FIGURE_HEIGHT, FIGURE_WIDTH);
 
@@ -43,31 +54,51 @@ void initializeParameters(GameParameters_t *parameters) {
   }
 
   parameters->data->score = 0;
+  parameters->data->high_score = 0;
+  parameters->dataPath = dataPath;
   resetField(parameters);
 
-  FILE *file = fopen(DATA_PATH, "r");
-  if (!file) {
-    parameters->data->high_score = 0;
-    file = fopen(DATA_PATH, "w");
+  FILE *file = dataPath ? fopen(dataPath, "r") : NULL;
+  if (dataPath && !file) {
+    file = fopen(dataPath, "w");
     fprintf(file, "0\n");
-  } else {
+  } else if (file) {
     int highScore;
 
     if (fscanf(file, "%d\n", &highScore) != 1) {
-      printf("Error: Unable to read data from external file (%s)", DATA_PATH);
+      printf("Error: Unable to read data from external file (%s)",
+             dataPath);
       exit(1);
     }
 
     parameters->data->high_score = highScore;
   }
-  fclose(file);
+  if (file) fclose(file);
+  parameters->savedHighScore = parameters->data->high_score;
 
   parameters->data->level = LEVEL_MIN;
   parameters->data->speed = SPEED_MIN;
   parameters->data->pause = 0;
-  parameters->figure->typeNext = generateRandomFigure(parameters->data->next);
+  parameters->ticks = 0;
+  parameters->gravityTick = 0;
+  parameters->spawnCount = 0;
+  parameters->queueLength = 1;
   parameters->state = START;
+  memset(&parameters->stats, 0, sizeof(parameters->stats));
+  resetAnalytics(&parameters->data->analytics);
+  parameters->analyticsPath = NULL;
   parameters->isActive = true;
+  seedParameters(parameters, (unsigned int)rand());
+}
+
+void seedParameters(GameParameters_t *parameters, unsigned int seed) {
+  parameters->seed = seed ? seed : 1;
+  parameters->figure->typeNext =
+      generateRandomFigure(parameters->data->next, &parameters->seed);
+
+  for (int i = 0; i < parameters->queueLength - 1; ++i) {
+    parameters->queue[i] = (int)(getRandom(&parameters->seed) % FIGURES_COUNT);
+  }
 }
 
 GameParameters_t *updateParameters(GameParameters_t *parameters) {
@@ -85,7 +116,46 @@ GameInfo_t updateCurrentState(void) {
   return *parameters->data;
 }
 
+void updateTicks(GameParameters_t *parameters, unsigned long ticks) {
+  unsigned long previousTicks = parameters->ticks;
+  bool isRunning = parameters->state == GAME && !parameters->data->pause;
+  bool isFalling = ticks > parameters->ticks;
+  while (isFalling) {
+    unsigned long gravityTick =
+        parameters->gravityTick + getGravityDelay(parameters->data->speed);
+
+    isFalling = parameters->state == GAME && !parameters->data->pause &&
+                gravityTick <= ticks;
+    if (isFalling) {
+      parameters->gravityTick = gravityTick;
+      parameters->ticks = gravityTick;
+      shiftFigure(parameters);
+    }
+  }
+
+  if (ticks > parameters->ticks) {
+    parameters->ticks = ticks;
+  }
+
+  if (isRunning) {
+    countAnalyticsTicks(&parameters->data->analytics,
+                        parameters->ticks - previousTicks);
+  }
+
+  if (parameters->state != GAME || parameters->data->pause) {
+    parameters->gravityTick = parameters->ticks;
+  }
+}
+
+unsigned long getGravityDelay(int speed) {
+  int delay = GRAVITY_DELAY_MAX - speed * GRAVITY_DELAY_STEP;
+
+  return delay > GRAVITY_DELAY_MIN ? (unsigned long)delay : GRAVITY_DELAY_MIN;
+}
+
 void shiftFigure(GameParameters_t *parameters) {
+  long long traceTime = beginTrace();
+  parameters->stats.values[STAT_GRAVITY_TICKS]++;
   clearFigure(parameters);
   parameters->figure->y++;
   bool canShift = isFigureNotCollide(parameters);
@@ -97,6 +167,8 @@ void shiftFigure(GameParameters_t *parameters) {
   if (!canShift) {
     attachFigure(parameters);
   }
+
+  endTrace("gravity", traceTime);
 }
 
 void clearFigure(GameParameters_t *parameters) {
@@ -121,6 +193,8 @@ bool isFigureNotCollide(GameParameters_t *parameters) {
   int type = parameters->figure->type;
   int rotation = parameters->figure->rotation;
 
+  parameters->stats.values[STAT_COLLIDE_CHECKS]++;
+
   bool isNotCollide = true;
   for (int i = 1; i < 8 && isNotCollide; i += 2) {
     int xx = (int)round(figures[type][i] * cos(PI_2 * rotation) +
@@ -153,29 +227,19 @@ void addFigure(GameParameters_t *parameters) {
 }
 
 void attachFigure(GameParameters_t *parameters) {
-  int rows = 0;
-  for (int row = FIELD_HEIGHT - BORDER_SIZE - 1; row > 2; --row) {
-    bool cycle = true;
-    while (cycle) {
-      int rowBlocks = 0;
-      for (int col = 3; col < FIELD_WIDTH - 3; ++col) {
-        if (parameters->data->field[row][col]) {
-          ++rowBlocks;
-        }
-      }
-
-      if (rowBlocks == FIELD_WIDTH - 6) {
-        ++rows;
-        for (int i = row; i > 1; --i) {
-          for (int col = BORDER_SIZE; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
-            parameters->data->field[i][col] =
-                parameters->data->field[i - 1][col];
-          }
-        }
-      } else {
-        cycle = false;
-      }
-    }
+  long long start = getStatsTime();
+  long long traceTime = beginTrace();
+  int rows = removeFullRows(parameters);
+  endTrace("line clear", traceTime);
+
+  parameters->stats.values[STAT_PIECES_LOCKED]++;
+  if (rows > 0) parameters->stats.values[STAT_CLEARS_1 + rows - 1]++;
+
+  // Figure is set only by spawn, so it isn't counted before the first one
+  if (parameters->spawnCount > 0) {
+    countAnalyticsPiece(&parameters->data->analytics,
+                        parameters->figure->type, parameters->figure->rotation,
+                        parameters->figure->x, parameters->figure->y, rows);
   }
 
   if (rows == 1) {
@@ -188,11 +252,9 @@ void attachFigure(GameParameters_t *parameters) {
     parameters->data->score += SCORE_ROWS_4;
   }
 
+  // High score is saved when game is over, not on every attach
   if (parameters->data->score > parameters->data->high_score) {
     parameters->data->high_score = parameters->data->score;
-    FILE *file = fopen(DATA_PATH, "w");
-    fprintf(file, "%d\n", parameters->data->high_score);
-    fclose(file);
   }
 
   parameters->data->level =
@@ -209,9 +271,44 @@ void attachFigure(GameParameters_t *parameters) {
   if (!canShift) {
     parameters->figure->y--;
     parameters->state = GAME_OVER;
+    saveHighScore(parameters);
+    saveAnalytics(parameters);
   }
 
   addFigure(parameters);
+
+  parameters->stats.values[STAT_ATTACH_NS] += getStatsTime() - start;
+  foldStats(&parameters->stats);
+  endTrace("attach", traceTime);
+}
+
+int removeFullRows(GameParameters_t *parameters) {
+  int rows = 0;
+  for (int row = FIELD_HEIGHT - BORDER_SIZE - 1; row > 2; --row) {
+    bool cycle = true;
+    while (cycle) {
+      int rowBlocks = 0;
+      for (int col = 3; col < FIELD_WIDTH - 3; ++col) {
+        if (parameters->data->field[row][col]) {
+          ++rowBlocks;
+        }
+      }
+
+      if (rowBlocks == FIELD_WIDTH - 6) {
+        ++rows;
+        for (int i = row; i > 1; --i) {
+          for (int col = BORDER_SIZE; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
+            parameters->data->field[i][col] =
+                parameters->data->field[i - 1][col];
+          }
+        }
+      } else {
+        cycle = false;
+      }
+    }
+  }
+
+  return rows;
 }
 
 void spawnNextFigure(GameParameters_t *parameters) {
@@ -219,13 +316,34 @@ void spawnNextFigure(GameParameters_t *parameters) {
   parameters->figure->x = FIELD_WIDTH / 2;
   parameters->figure->y = 2;
   parameters->figure->rotation = 0;
-  parameters->figure->typeNext = generateRandomFigure(parameters->data->next);
+
+  int last = parameters->queueLength - 2;
+  if (last < 0) {
+    parameters->figure->typeNext =
+        generateRandomFigure(parameters->data->next, &parameters->seed);
+  } else {
+    parameters->figure->typeNext = parameters->queue[0];
+    drawNextFigure(parameters->data->next, parameters->figure->typeNext);
+
+    for (int i = 0; i < last; ++i) {
+      parameters->queue[i] = parameters->queue[i + 1];
+    }
+    parameters->queue[last] =
+        (int)(getRandom(&parameters->seed) % FIGURES_COUNT);
+  }
+
+  parameters->spawnCount++;
   addFigure(parameters);
 }
 
-int generateRandomFigure(int **next) {
-  int type = rand() % FIGURES_COUNT;
+int generateRandomFigure(int **next, unsigned int *seed) {
+  int type = (int)(getRandom(seed) % FIGURES_COUNT);
+  drawNextFigure(next, type);
+
+  return type;
+}
 
+void drawNextFigure(int **next, int type) {
   for (int row = 0; row < FIGURE_HEIGHT; ++row) {
     for (int col = 0; col < FIGURE_WIDTH; ++col) {
       next[row][col] = PIXEL_EMPTY;
@@ -235,8 +353,32 @@ int generateRandomFigure(int **next) {
   for (int i = 1; i < 8; i += 2) {
     next[figures[type][i - 1] + 1][figures[type][i] + 1] = type + 1;
   }
+}
 
-  return type;
+void setQueueLength(GameParameters_t *parameters, int length) {
+  if (length < 1) length = 1;
+  if (length > QUEUE_MAX) length = QUEUE_MAX;
+
+  for (int i = parameters->queueLength - 1; i < length - 1; ++i) {
+    parameters->queue[i] = (int)(getRandom(&parameters->seed) % FIGURES_COUNT);
+  }
+
+  parameters->queueLength = length;
+}
+
+int getQueuedFigure(const GameParameters_t *parameters, int index) {
+  return index > 0 ? parameters->queue[index - 1]
+                   : parameters->figure->typeNext;
+}
+
+unsigned int getRandom(unsigned int *seed) {
+  unsigned int x = *seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *seed = x;
+
+  return x;
 }
 
 void userInput(UserAction_t action, bool hold) {
@@ -244,7 +386,10 @@ void userInput(UserAction_t action, bool hold) {
     printf("\x1b");  // ESC
   }
 
-  GameParameters_t *parameters = updateParameters(NULL);
+  processAction(updateParameters(NULL), action);
+}
+
+void processAction(GameParameters_t *parameters, UserAction_t action) {
   GameState_t state = parameters->state;
   funcPointer func = fsmTable[state][action];
 
@@ -278,6 +423,56 @@ void removeParameters(GameParameters_t *parameters) {
   parameters->isActive = false;
 }
 
+void saveHighScore(GameParameters_t *parameters) {
+  if (parameters->dataPath &&
+      parameters->data->high_score > parameters->savedHighScore) {
+    long long traceTime = beginTrace();
+    char text[16];
+    int length = snprintf(text, sizeof(text), "%d\n",
+                          parameters->data->high_score);
+    int fd = open(parameters->dataPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd >= 0) {
+      if (write(fd, text, (size_t)length) == length) {
+        parameters->savedHighScore = parameters->data->high_score;
+      }
+      close(fd);
+    }
+
+    endTrace("saveHighScore", traceTime);
+  }
+}
+
+bool saveAnalytics(GameParameters_t *parameters) {
+  bool isSaved = false;
+
+  if (parameters->analyticsPath) {
+    char text[ANALYTICS_TEXT_SIZE];
+    int length = formatAnalytics(&parameters->data->analytics,
+                                 parameters->data->score,
+                                 parameters->state == GAME_OVER, text,
+                                 sizeof(text));
+    int fd = length > 0 ? open(parameters->analyticsPath,
+                               O_WRONLY | O_CREAT | O_APPEND, 0644)
+                        : -1;
+
+    // One write per summary, so lines of games are never mixed
+    if (fd >= 0) {
+      isSaved = write(fd, text, (size_t)length) == length;
+      close(fd);
+    }
+  }
+
+  return isSaved;
+}
+
+void terminateGame(GameParameters_t *parameters) {
+  foldStats(&parameters->stats);
+  saveHighScore(parameters);
+  if (parameters->state == GAME) saveAnalytics(parameters);
+  removeParameters(parameters);
+}
+
 int **allocate2DArray(int nRows, int nCols) {
   int **arr = (int **)calloc(nRows, sizeof(int *));
 
@@ -303,17 +498,9 @@ void resetField(GameParameters_t *parameters) {
 void startGame(GameParameters_t *parameters) {
   resetField(parameters);
 
-  FILE *file = fopen(DATA_PATH, "r");
-  int highScore;
-
-  if (fscanf(file, "%d\n", &highScore) != 1) {
-    printf("Error: Unable to read data from external file (%s)", DATA_PATH);
-    exit(1);
-  }
-
-  parameters->data->high_score = highScore;
-  fclose(file);
-
+  // High score is read once by initializeParameters and kept in memory
+  resetStats(&parameters->stats);
+  resetAnalytics(&parameters->data->analytics);
   parameters->data->score = 0;
   parameters->data->level = LEVEL_MIN;
   parameters->data->speed = SPEED_MIN;
@@ -324,12 +511,14 @@ void startGame(GameParameters_t *parameters) {
 
 void moveLeft(GameParameters_t *parameters) {
   if (!parameters->data->pause) {
+    countAnalyticsAction(&parameters->data->analytics, true);
     clearFigure(parameters);
     parameters->figure->x--;
     bool canMove = isFigureNotCollide(parameters);
 
     if (!canMove) {
       parameters->figure->x++;
+      parameters->stats.values[STAT_FAILED_MOVES]++;
     }
 
     addFigure(parameters);
@@ -338,12 +527,14 @@ void moveLeft(GameParameters_t *parameters) {
 
 void moveRight(GameParameters_t *parameters) {
   if (!parameters->data->pause) {
+    countAnalyticsAction(&parameters->data->analytics, true);
     clearFigure(parameters);
     parameters->figure->x++;
     bool canMove = isFigureNotCollide(parameters);
 
     if (!canMove) {
       parameters->figure->x--;
+      parameters->stats.values[STAT_FAILED_MOVES]++;
     }
 
     addFigure(parameters);
@@ -352,6 +543,7 @@ void moveRight(GameParameters_t *parameters) {
 
 void moveDown(GameParameters_t *parameters) {
   if (!parameters->data->pause) {
+    countAnalyticsAction(&parameters->data->analytics, false);
     clearFigure(parameters);
 
     bool canMove = true;
@@ -371,6 +563,7 @@ void moveDown(GameParameters_t *parameters) {
 
 void rotateFigure(GameParameters_t *parameters) {
   if (!parameters->data->pause) {
+    countAnalyticsAction(&parameters->data->analytics, true);
     clearFigure(parameters);
     parameters->figure->rotation =
         parameters->figure->rotation + 1 <= ROTATION_MAX
@@ -379,6 +572,7 @@ void rotateFigure(GameParameters_t *parameters) {
     bool canRotate = isFigureNotCollide(parameters);
 
     if (!canRotate) {
+      parameters->stats.values[STAT_FAILED_ROTATIONS]++;
       parameters->figure->rotation =
           parameters->figure->rotation - 1 >= ROTATION_MIN
               ? parameters->figure->rotation - 1
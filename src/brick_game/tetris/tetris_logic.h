@@ -12,6 +12,9 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "tetris_analytics.h"
+#include "tetris_stats.h"
+
 #define PI_2 1.57079632679489661923
 
 #define FIELD_WIDTH 16
@@ -24,6 +27,7 @@
 #define STATES_COUNT 3
 #define SIGNALS_COUNT 8
 #define FIGURES_COUNT 7
+#define QUEUE_MAX 6  // upcoming figures known to player and bot
 
 #define DATA_PATH "./data"
 
@@ -41,6 +45,11 @@
 #define ROTATION_MIN 0
 #define ROTATION_MAX 3
 
+#define TICK_RATE 1000          // Hz
+#define GRAVITY_DELAY_MAX 1600  // ticks
+#define GRAVITY_DELAY_STEP 160  // ticks per speed
+#define GRAVITY_DELAY_MIN 17    // ticks
+
 /*****************************************************************************
  * @brief Game data struct
  *
@@ -53,6 +62,7 @@
  * @param level Current game level: [1..10]
  * @param speed Current game speed: [1..10]
  * @param pause Pause flag
+ * @param analytics Player analytics of current game
  *****************************************************************************/
 typedef struct {
   int **field;
@@ -62,6 +72,7 @@ typedef struct {
   int level;
   int speed;
   int pause;
+  Analytics_t analytics;
 } GameInfo_t;
 
 /*****************************************************************************
@@ -99,12 +110,34 @@ typedef struct {
  * @param state Game current state
  * @param isActive Flag for activate game loop
  * @param figure Current figure data
+ * @param ticks Logic clock: ticks elapsed since game initialization
+ * @param gravityTick Tick of the last gravity shift
+ * @param seed State of the figure generator
+ * @param dataPath Path to high score file, NULL to keep high score in memory
+ * @param savedHighScore High score written to file of dataPath
+ * @param spawnCount Number of figures spawned since initialization
+ * @param queue Types of figures that follow figure->typeNext
+ * @param queueLength Number of upcoming figures including typeNext:
+ *[1..QUEUE_MAX]
+ * @param stats Hot path counters of current game
+ * @param analyticsPath Path to file game summaries are appended to, NULL for
+ *no summaries
  *****************************************************************************/
 typedef struct {
   GameInfo_t *data;
   GameState_t state;
   bool isActive;
   Figure_t *figure;
+  unsigned long ticks;
+  unsigned long gravityTick;
+  unsigned int seed;
+  const char *dataPath;
+  int savedHighScore;
+  unsigned long spawnCount;
+  int queue[QUEUE_MAX - 1];
+  int queueLength;
+  Stats_t stats;
+  const char *analyticsPath;
 } GameParameters_t;
 
 /*****************************************************************************
@@ -133,6 +166,28 @@ typedef enum {
  *****************************************************************************/
 void initializeParameters(GameParameters_t *parameters);
 
+/*****************************************************************************
+ * @brief Initialize game parameters with high score file
+ *
+ * The same as initializeParameters, but high score is kept in dataPath
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param dataPath Path to high score file, NULL to keep high score in memory
+ *****************************************************************************/
+void initializeParametersPath(GameParameters_t *parameters,
+                              const char *dataPath);
+
+/*****************************************************************************
+ * @brief Seed game parameters
+ *
+ * Reset figure generator to seed and regenerate upcoming figures, so that the
+ *same seed and the same actions at the same ticks give the same game
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param seed Seed of figure generator
+ *****************************************************************************/
+void seedParameters(GameParameters_t *parameters, unsigned int seed);
+
 /*****************************************************************************
  * @brief Update game parameters
  *
@@ -151,6 +206,28 @@ GameParameters_t *updateParameters(GameParameters_t *parameters);
  *****************************************************************************/
 GameInfo_t updateCurrentState(void);
 
+/*****************************************************************************
+ * @brief Update logic clock
+ *
+ * Advance logic clock to the given tick and shift current figure down at
+ *every gravity tick on the way. Gravity is counted only during the game and
+ *not on pause. Logic clock never goes back
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param ticks Tick to advance logic clock to
+ *****************************************************************************/
+void updateTicks(GameParameters_t *parameters, unsigned long ticks);
+
+/*****************************************************************************
+ * @brief Get gravity delay
+ *
+ * Get number of ticks between gravity shifts for the given speed
+ *
+ * @param speed Current game speed: [1..10]
+ * @return unsigned long Gravity delay in ticks
+ *****************************************************************************/
+unsigned long getGravityDelay(int speed);
+
 /*****************************************************************************
  * @brief Shift figure down
  *
@@ -198,6 +275,16 @@ void addFigure(GameParameters_t *parameters);
  *****************************************************************************/
 void attachFigure(GameParameters_t *parameters);
 
+/*****************************************************************************
+ * @brief Remove full rows
+ *
+ * Remove filled rows of game field and shift rows above them down
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @return int Number of removed rows
+ *****************************************************************************/
+int removeFullRows(GameParameters_t *parameters);
+
 /*****************************************************************************
  * @brief Spawn next figure
  *
@@ -213,9 +300,50 @@ void spawnNextFigure(GameParameters_t *parameters);
  * Generate random figure from possible variants
  *
  * @param next Pointer to array of the next figure for preview
+ * @param seed Pointer to state of the figure generator
  * @return Figure type number in figures array
  *****************************************************************************/
-int generateRandomFigure(int **next);
+int generateRandomFigure(int **next, unsigned int *seed);
+
+/*****************************************************************************
+ * @brief Draw next figure
+ *
+ * Draw figure into array of the next figure for preview
+ *
+ * @param next Pointer to array of the next figure for preview
+ * @param type Figure type number in figures array
+ *****************************************************************************/
+void drawNextFigure(int **next, int type);
+
+/*****************************************************************************
+ * @brief Set queue length
+ *
+ * Set number of upcoming figures. Figures already in queue are kept, new ones
+ *are generated
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param length Number of upcoming figures: [1..QUEUE_MAX]
+ *****************************************************************************/
+void setQueueLength(GameParameters_t *parameters, int length);
+
+/*****************************************************************************
+ * @brief Get upcoming figure
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param index Index of upcoming figure: 0 for typeNext, [0..queueLength)
+ * @return int Figure type number in figures array
+ *****************************************************************************/
+int getQueuedFigure(const GameParameters_t *parameters, int index);
+
+/*****************************************************************************
+ * @brief Get random number
+ *
+ * Xorshift generator: same sequence for the same seed on every platform
+ *
+ * @param seed Pointer to state of generator, updated on every call
+ * @return unsigned int Random number
+ *****************************************************************************/
+unsigned int getRandom(unsigned int *seed);
 
 /*****************************************************************************
  * @brief User's input processing
@@ -227,6 +355,17 @@ int generateRandomFigure(int **next);
  *****************************************************************************/
 void userInput(UserAction_t action, bool hold);
 
+/*****************************************************************************
+ * @brief Process action
+ *
+ * Activate function, assigned to game state and action into FSM table, for
+ *the given game
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param action User's action
+ *****************************************************************************/
+void processAction(GameParameters_t *parameters, UserAction_t action);
+
 /*****************************************************************************
  * @brief Remove game parameters
  *
@@ -236,6 +375,36 @@ void userInput(UserAction_t action, bool hold);
  *****************************************************************************/
 void removeParameters(GameParameters_t *parameters);
 
+/*****************************************************************************
+ * @brief Save high score
+ *
+ * Write high score to file of dataPath if it is higher than the saved one.
+ *File is written by descriptor without stdio, so nothing is allocated
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void saveHighScore(GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Save analytics
+ *
+ * Append summary of current game to file of analyticsPath. File is written by
+ *descriptor without stdio, so nothing is allocated
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @return bool False if there is no file or summary can't be written
+ *****************************************************************************/
+bool saveAnalytics(GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Terminate game
+ *
+ * Save high score and remove game parameters
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void terminateGame(GameParameters_t *parameters);
+
 /*****************************************************************************
  * @brief Allocate memory for 2D array
  *
@@ -319,4 +488,11 @@ void pauseGame(GameParameters_t *parameters);
  *****************************************************************************/
 typedef void (*funcPointer)(GameParameters_t *parameters);
 
+/*****************************************************************************
+ * @brief Relative coordinates of figures
+ *
+ * Row and col offsets of four pixels of every figure from its center
+ *****************************************************************************/
+extern int figures[FIGURES_COUNT][8];
+
 #endif  // TETRIS_H
@@ -0,0 +1,296 @@
+/*****************************************************************************
+ * @file tetris_pc.c
+ * @brief Source File with Perfect Clear Solver
+ *****************************************************************************/
+
+#include "tetris_pc.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PC_COL_FIRST 0x40100401ull  // col 0 of every region row
+#define PC_REGION_BOTTOM (FIELD_HEIGHT - BORDER_SIZE - 1)
+
+static long long getPcTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static uint64_t getHeightMask(int height) {
+  return (1ull << (PC_COLS * height)) - 1;
+}
+
+static int getDatabaseOffset(int height) {
+  return PC_DB_MAGIC_SIZE + (height > 1 ? (1 << PC_COLS) / 8 : 0);
+}
+
+// Region of board after piece placed inside the lowest rows, -1 if outside
+static int placePcPiece(const Board_t *board, int type,
+                        const Placement_t *placement, int height,
+                        uint64_t *region) {
+  const Piece_t *piece = getPiece(type, placement->rotation);
+  int lines = -1;
+
+  if (placement->y + piece->top > PC_REGION_BOTTOM - height) {
+    Board_t next = *board;
+    lines = placePiece(&next, piece, placement->x, placement->y);
+    getPcRegion(&next, region);
+  }
+
+  return lines;
+}
+
+void initializePerfectClear(PerfectClear_t *pc, const char *dbPath,
+                            int tableBits) {
+  initializeHashTable(&pc->table, tableBits);
+  pc->db = NULL;
+  pc->isTimeout = false;
+  pc->nodes = 0;
+
+  int fd = dbPath ? open(dbPath, O_RDONLY) : -1;
+  struct stat info;
+
+  if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size == PC_DB_SIZE) {
+    void *db = mmap(NULL, PC_DB_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (db != MAP_FAILED &&
+        memcmp(db, PC_DB_MAGIC, PC_DB_MAGIC_SIZE) == 0) {
+      pc->db = db;
+    } else if (db != MAP_FAILED) {
+      munmap(db, PC_DB_SIZE);
+    }
+  }
+
+  if (fd >= 0) close(fd);
+}
+
+bool getPcRegion(const Board_t *board, uint64_t *region) {
+  bool isLow = true;
+  *region = 0;
+
+  for (int row = 0; row <= PC_REGION_BOTTOM; ++row) {
+    uint64_t bits = (board->rows[row] & ROW_FULL) >> BORDER_SIZE;
+    int k = PC_REGION_BOTTOM - row;
+
+    if (k < PC_ROWS) {
+      *region |= bits << (k * PC_COLS);
+    } else if (bits) {
+      isLow = false;
+    }
+  }
+
+  return isLow;
+}
+
+void getPcBoard(uint64_t region, Board_t *board) {
+  resetBoard(board);
+
+  for (int k = 0; k < PC_ROWS; ++k) {
+    board->rows[PC_REGION_BOTTOM - k] |=
+        (uint16_t)(((region >> (k * PC_COLS)) & PC_ROW_MASK) << BORDER_SIZE);
+  }
+}
+
+bool isPcFillable(uint64_t region, int height) {
+  uint64_t empty = ~region & getHeightMask(height);
+  bool isFillable = true;
+
+  while (empty && isFillable) {
+    uint64_t group = empty & (~empty + 1);
+    uint64_t grown = group;
+
+    do {
+      group = grown;
+      grown = (group | ((group << 1) & ~PC_COL_FIRST) |
+               ((group >> 1) & ~(PC_COL_FIRST << (PC_COLS - 1))) |
+               (group << PC_COLS) | (group >> PC_COLS)) &
+              empty;
+    } while (grown != group);
+
+    isFillable = __builtin_popcountll(group) % 4 == 0;
+    empty &= ~group;
+  }
+
+  return isFillable;
+}
+
+int solvePerfectClear(PerfectClear_t *pc, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placements) {
+  int sequence[PC_PIECES_MAX];
+  int count = 0;
+  uint64_t region;
+
+  if (typesCount > PC_PIECES_MAX - 1) typesCount = PC_PIECES_MAX - 1;
+  sequence[0] = figure->type;
+  memcpy(sequence + 1, types, sizeof(types[0]) * (size_t)typesCount);
+  pc->deadline = deadline;
+  pc->isTimeout = false;
+  pc->nodes = 0;
+
+  if (getPcRegion(board, &region)) {
+    int filled = __builtin_popcountll(region);
+
+    for (int height = 1; height <= PC_ROWS && count == 0 && !pc->isTimeout;
+         ++height) {
+      int empty = PC_COLS * height - filled;
+
+      if (!(region & ~getHeightMask(height)) && empty > 0 &&
+          empty % 4 == 0 && empty / 4 <= typesCount + 1 &&
+          searchPerfectClear(pc, region, height, figure, sequence,
+                             empty / 4, placements)) {
+        count = empty / 4;
+      }
+    }
+  }
+
+  return count;
+}
+
+bool searchPerfectClear(PerfectClear_t *pc, uint64_t region, int height,
+                        const Figure_t *figure, const int *types, int count,
+                        Placement_t *placements) {
+  int empty = PC_COLS * height - __builtin_popcountll(region);
+  bool isFound = height == 0;
+
+  // Key holds region, height and every remaining type, so it is exact
+  uint64_t key = region | (uint64_t)height << (PC_COLS * PC_ROWS);
+  for (int i = 0; i < count; ++i) {
+    key |= (uint64_t)(types[i] + 1) << (PC_COLS * PC_ROWS + 3 + i * 3);
+  }
+  bool isMemo = figure == NULL;
+  uint64_t data;
+
+  if (!isFound && count > 0 && empty % 4 == 0 && empty <= count * 4 &&
+      isPcFillable(region, height) && isPcSolvable(pc, region, height) &&
+      !(isMemo && probeHash(&pc->table, key, &data))) {
+    Board_t board;
+    Figure_t spawned;
+    Placement_t moves[PLACEMENTS_MAX];
+    int movesCount = 0;
+
+    ++pc->nodes;
+    getPcBoard(region, &board);
+
+    if (getPcTime() >= pc->deadline) {
+      pc->isTimeout = true;
+    } else if (figure) {
+      movesCount = generatePlacements(&board, figure, moves);
+    } else if (spawnBoardFigure(&board, types[0], &spawned)) {
+      movesCount = generatePlacements(&board, &spawned, moves);
+    }
+
+    for (int i = 0; i < movesCount && !isFound && !pc->isTimeout; ++i) {
+      uint64_t next;
+      int lines = placePcPiece(&board, types[0], &moves[i], height, &next);
+
+      if (lines >= 0 &&
+          searchPerfectClear(pc, next, height - lines, NULL, types + 1,
+                             count - 1, placements + 1)) {
+        placements[0] = moves[i];
+        isFound = true;
+      }
+    }
+
+    if (isMemo && !isFound && !pc->isTimeout) {
+      storeHash(&pc->table, key, 1);
+    }
+  }
+
+  return isFound;
+}
+
+bool isPcSolvable(const PerfectClear_t *pc, uint64_t region, int height) {
+  bool isSolvable = true;
+
+  if (pc->db && height <= PC_DB_HEIGHT) {
+    isSolvable =
+        pc->db[getDatabaseOffset(height) + region / 8] >> (region % 8) & 1;
+  }
+
+  return isSolvable;
+}
+
+// Check that some figures clear region, results are kept in bitmaps
+static bool isAnySolvable(uint64_t region, int height, unsigned char *solved,
+                          unsigned char *known) {
+  int empty = PC_COLS * height - __builtin_popcountll(region);
+  int offset = getDatabaseOffset(height) - PC_DB_MAGIC_SIZE;
+  unsigned char bit = (unsigned char)(1u << (region % 8));
+  bool isSolvable = height == 0;
+
+  if (isSolvable) {
+    // All rows are removed
+  } else if (empty % 4 != 0 || !isPcFillable(region, height)) {
+    isSolvable = false;
+  } else if (known[offset + region / 8] & bit) {
+    isSolvable = solved[offset + region / 8] & bit;
+  } else {
+    Board_t board;
+    Placement_t moves[PLACEMENTS_MAX];
+    getPcBoard(region, &board);
+
+    for (int type = 0; type < FIGURES_COUNT && !isSolvable; ++type) {
+      Figure_t figure;
+      int count = spawnBoardFigure(&board, type, &figure)
+                      ? generatePlacements(&board, &figure, moves)
+                      : 0;
+
+      for (int i = 0; i < count && !isSolvable; ++i) {
+        uint64_t next;
+        int lines = placePcPiece(&board, type, &moves[i], height, &next);
+
+        isSolvable = lines >= 0 &&
+                     isAnySolvable(next, height - lines, solved, known);
+      }
+    }
+
+    known[offset + region / 8] |= bit;
+    if (isSolvable) solved[offset + region / 8] |= bit;
+  }
+
+  return isSolvable;
+}
+
+unsigned long buildPcDatabase(const char *path) {
+  size_t size = PC_DB_SIZE - PC_DB_MAGIC_SIZE;
+  unsigned char *solved = calloc(size, 1);
+  unsigned char *known = calloc(size, 1);
+  unsigned long count = 0;
+
+  if (NULL == solved || NULL == known) {
+    printf("\nNot enough memory...\n");
+    exit(1);
+  }
+
+  for (int height = 1; height <= PC_DB_HEIGHT; ++height) {
+    for (uint64_t region = 0; region <= getHeightMask(height); ++region) {
+      count += isAnySolvable(region, height, solved, known);
+    }
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (NULL == file || fwrite(PC_DB_MAGIC, 1, PC_DB_MAGIC_SIZE, file) !=
+                          PC_DB_MAGIC_SIZE ||
+      fwrite(solved, 1, size, file) != size) {
+    count = 0;
+  }
+  if (file && fclose(file) != 0) count = 0;
+
+  free(solved);
+  free(known);
+
+  return count;
+}
+
+void removePerfectClear(PerfectClear_t *pc) {
+  if (pc->db) munmap((void *)pc->db, PC_DB_SIZE);
+  pc->db = NULL;
+  removeHashTable(&pc->table);
+}
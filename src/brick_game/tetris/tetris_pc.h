@@ -0,0 +1,162 @@
+#ifndef PC_H
+#define PC_H
+
+/*****************************************************************************
+ * @file tetris_pc.h
+ * @brief Header File with Perfect Clear Solver
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tetris_board.h"
+#include "tetris_hash.h"
+#include "tetris_logic.h"
+
+#define PC_ROWS 4
+#define PC_COLS 10
+#define PC_ROW_MASK ((1ull << PC_COLS) - 1)
+#define PC_PIECES_MAX (QUEUE_MAX + 1)  // current figure and queue
+#define PC_BUDGET 2000000LL            // ns of search per figure
+#define PC_DB_HEIGHT 2                 // rows of the highest database region
+#define PC_DB_MAGIC "TPCDB001"
+#define PC_DB_MAGIC_SIZE 8
+#define PC_DB_SIZE \
+  (PC_DB_MAGIC_SIZE + (1 << PC_COLS) / 8 + (1 << (PC_COLS * 2)) / 8)
+#define PC_DB_PATH "./pc.db"
+
+/*****************************************************************************
+ * @brief Perfect clear solver struct
+ *
+ * Region of the lowest PC_ROWS rows is a 40-bit board: bit row * PC_COLS +
+ *col, row 0 is the floor row. Solver searches placements of known figures
+ *inside the lowest rows until all of them are removed. Failed states are
+ *memoized by region, height and remaining figures, so they stay valid
+ *between searches
+ *
+ * @param table Transposition table of failed states
+ * @param db Mapped database of regions solvable by some figures, NULL if
+ *there is no database
+ * @param deadline Monotonic time in ns to stop search
+ * @param isTimeout Flag that search has passed deadline
+ * @param nodes Number of states searched by the last solve
+ *****************************************************************************/
+typedef struct {
+  HashTable_t table;
+  const unsigned char *db;
+  long long deadline;
+  bool isTimeout;
+  unsigned long nodes;
+} PerfectClear_t;
+
+/*****************************************************************************
+ * @brief Initialize perfect clear solver
+ *
+ * Allocate table and map database if it exists and is valid
+ *
+ * @param pc Pointer to struct of PerfectClear_t
+ * @param dbPath Path of database or NULL
+ * @param tableBits Size of table: 1 << bits entries
+ *****************************************************************************/
+void initializePerfectClear(PerfectClear_t *pc, const char *dbPath,
+                            int tableBits);
+
+/*****************************************************************************
+ * @brief Get region of board
+ *
+ * @param board Pointer to struct of Board_t
+ * @param region Pointer to 40-bit region to fill
+ * @return bool False if there are pixels above region
+ *****************************************************************************/
+bool getPcRegion(const Board_t *board, uint64_t *region);
+
+/*****************************************************************************
+ * @brief Get board of region
+ *
+ * @param region 40-bit region
+ * @param board Pointer to struct of Board_t to fill
+ *****************************************************************************/
+void getPcBoard(uint64_t region, Board_t *board);
+
+/*****************************************************************************
+ * @brief Check region for dead holes
+ *
+ * Every connected group of empty pixels of the lowest rows must be filled by
+ *whole figures
+ *
+ * @param region 40-bit region
+ * @param height Number of rows to clear
+ * @return bool False if some empty group can't be filled by figures
+ *****************************************************************************/
+bool isPcFillable(uint64_t region, int height);
+
+/*****************************************************************************
+ * @brief Solve perfect clear
+ *
+ * Find placements of current figure and the next known figures that remove
+ *all pixels of board. The lowest heights are tried first
+ *
+ * @param pc Pointer to struct of PerfectClear_t
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param types Types of upcoming figures
+ * @param typesCount Number of upcoming figures
+ * @param deadline Monotonic time in ns to stop search
+ * @param placements Placements of figures to fill, the first one is of
+ *current figure
+ * @return int Number of placements, 0 if there is no perfect clear or it
+ *wasn't found before deadline
+ *****************************************************************************/
+int solvePerfectClear(PerfectClear_t *pc, const Board_t *board,
+                      const Figure_t *figure, const int *types,
+                      int typesCount, long long deadline,
+                      Placement_t *placements);
+
+/*****************************************************************************
+ * @brief Search perfect clear
+ *
+ * @param pc Pointer to struct of PerfectClear_t
+ * @param region 40-bit region
+ * @param height Number of rows left to clear
+ * @param figure Pointer to current figure or NULL to spawn figure of types
+ * @param types Types of figures, the first one is placed now
+ * @param count Number of figures
+ * @param placements Placements of figures to fill
+ * @return bool True if all rows are removed
+ *****************************************************************************/
+bool searchPerfectClear(PerfectClear_t *pc, uint64_t region, int height,
+                        const Figure_t *figure, const int *types, int count,
+                        Placement_t *placements);
+
+/*****************************************************************************
+ * @brief Check database
+ *
+ * @param pc Pointer to struct of PerfectClear_t
+ * @param region 40-bit region
+ * @param height Number of rows left to clear
+ * @return bool False if database shows that no figures can clear region
+ *****************************************************************************/
+bool isPcSolvable(const PerfectClear_t *pc, uint64_t region, int height);
+
+/*****************************************************************************
+ * @brief Build database
+ *
+ * Find regions of 1 and PC_DB_HEIGHT rows that some sequence of figures can
+ *clear and write their bitmaps to file
+ *
+ * @param path Path of database
+ * @return unsigned long Number of solvable regions, 0 if file can't be written
+ *****************************************************************************/
+unsigned long buildPcDatabase(const char *path);
+
+/*****************************************************************************
+ * @brief Remove perfect clear solver
+ *
+ * Clear allocated memory and unmap database
+ *
+ * @param pc Pointer to struct of PerfectClear_t
+ *****************************************************************************/
+void removePerfectClear(PerfectClear_t *pc);
+
+#endif  // PC_H
@@ -0,0 +1,244 @@
+/*****************************************************************************
+ * @file tetris_rollout.c
+ * @brief Source File with Monte Carlo Rollout Search
+ *****************************************************************************/
+
+#include "tetris_rollout.h"
+
+#include <string.h>
+#include <unistd.h>
+
+static long long getRolloutTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static uint64_t getRolloutRandom(uint64_t *random) {
+  // xorshift64*
+  *random ^= *random >> 12;
+  *random ^= *random << 25;
+  *random ^= *random >> 27;
+
+  return *random * 0x2545F4914F6CDD1Dull;
+}
+
+void initializeRollout(Rollout_t *rollout, int depth, int threadsCount,
+                       uint64_t seed) {
+  if (depth < 0) depth = 0;
+  if (threadsCount < 1) threadsCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threadsCount < 1) threadsCount = 1;
+  if (threadsCount > ROLLOUT_THREADS_MAX) threadsCount = ROLLOUT_THREADS_MAX;
+
+  rollout->depth = depth;
+  rollout->count = 0;
+  rollout->threadsCount = threadsCount;
+  rollout->generation = 0;
+  rollout->pending = 0;
+  rollout->isActive = true;
+  rollout->rollouts = 0;
+  rollout->time = 0;
+  pthread_mutex_init(&rollout->mutex, NULL);
+  pthread_cond_init(&rollout->start, NULL);
+  pthread_cond_init(&rollout->done, NULL);
+
+  for (int i = 0; i < threadsCount; ++i) {
+    RolloutWorker_t *worker = &rollout->workers[i];
+    worker->index = i;
+    worker->rollout = rollout;
+    worker->random = (seed + (uint64_t)i) * 0x9E3779B97F4A7C15ull;
+    if (!worker->random) worker->random = 1;
+    worker->scratch = malloc(sizeof(RolloutScratch_t));
+
+    if (NULL == worker->scratch) {
+      printf("\nNot enough memory...\n");
+      exit(1);
+    }
+
+    if (i > 0 && pthread_create(&worker->thread, NULL, runRolloutWorker,
+                                worker) != 0) {
+      printf("\nUnable to start rollout search...\n");
+      exit(1);
+    }
+  }
+}
+
+unsigned long searchRollout(Rollout_t *rollout, const Board_t *board,
+                            const Figure_t *figure, int typeNext,
+                            long long deadline, Placement_t *placement) {
+  long long start = getRolloutTime();
+  unsigned long rollouts = 0;
+
+  rollout->count = generatePlacements(board, figure, rollout->placements);
+  rollout->typeNext = typeNext;
+  rollout->deadline = deadline;
+
+  for (int i = 0; i < rollout->count; ++i) {
+    const Placement_t *candidate = &rollout->placements[i];
+    rollout->boards[i] = *board;
+    rollout->lines[i] =
+        placePiece(&rollout->boards[i],
+                   getPiece(figure->type, candidate->rotation), candidate->x,
+                   candidate->y);
+  }
+
+  if (rollout->count > 0) {
+    pthread_mutex_lock(&rollout->mutex);
+    rollout->generation++;
+    rollout->pending = rollout->threadsCount - 1;
+    pthread_cond_broadcast(&rollout->start);
+    pthread_mutex_unlock(&rollout->mutex);
+
+    playRollouts(rollout, &rollout->workers[0]);
+
+    pthread_mutex_lock(&rollout->mutex);
+    while (rollout->pending > 0) {
+      pthread_cond_wait(&rollout->done, &rollout->mutex);
+    }
+    pthread_mutex_unlock(&rollout->mutex);
+
+    // Root parallelism: statistics of workers are summed per candidate
+    int best = 0;
+    double bestValue = 0;
+    for (int i = 0; i < rollout->count; ++i) {
+      double value = 0;
+      unsigned long count = 0;
+
+      for (int j = 0; j < rollout->threadsCount; ++j) {
+        value += rollout->workers[j].scratch->values[i];
+        count += rollout->workers[j].scratch->counts[i];
+      }
+
+      value /= (double)count;
+      rollouts += count;
+      if (i == 0 || value > bestValue) {
+        best = i;
+        bestValue = value;
+      }
+    }
+
+    *placement = rollout->placements[best];
+  }
+
+  rollout->rollouts += rollouts;
+  rollout->time += getRolloutTime() - start;
+
+  return rollouts;
+}
+
+void playRollouts(Rollout_t *rollout, RolloutWorker_t *worker) {
+  RolloutScratch_t *scratch = worker->scratch;
+  bool isTimeout = false;
+
+  memset(scratch->values, 0, sizeof(scratch->values[0]) * rollout->count);
+  memset(scratch->counts, 0, sizeof(scratch->counts[0]) * rollout->count);
+
+  // The first sweep is always played to have a value of every candidate
+  while (!isTimeout) {
+    for (int i = 0; i < rollout->count; ++i) {
+      scratch->values[i] +=
+          rollout->lines[i] + playRollout(&rollout->boards[i],
+                                          rollout->typeNext, rollout->depth,
+                                          &worker->random);
+      scratch->counts[i]++;
+    }
+
+    isTimeout = getRolloutTime() >= rollout->deadline;
+  }
+}
+
+double playRollout(const Board_t *board, int type, int depth,
+                   uint64_t *random) {
+  Board_t current = *board;
+  double value = 0;
+  bool isOver = false;
+
+  for (int k = 0; k < depth && !isOver; ++k) {
+    Figure_t figure;
+    Placement_t drops[ROTATIONS_COUNT * FIELD_WIDTH];
+    int count = 0;
+
+    if (k > 0) type = (int)(getRolloutRandom(random) % FIGURES_COUNT);
+
+    if (spawnBoardFigure(&current, type, &figure)) {
+      // Drops of distinct shapes from every column of spawn row
+      for (int rotation = 0; rotation < ROTATIONS_COUNT; ++rotation) {
+        const Piece_t *piece = getPiece(type, rotation);
+
+        for (int shift = 0; shift <= FIELD_WIDTH - PIECE_HEIGHT &&
+                            piece->shape == rotation;
+             ++shift) {
+          int x = shift - piece->left;
+
+          if (!isPieceCollide(&current, piece, x, figure.y)) {
+            drops[count++] = (Placement_t){(unsigned char)x,
+                                           (unsigned char)figure.y,
+                                           (unsigned char)rotation};
+          }
+        }
+      }
+    }
+
+    if (count > 0) {
+      Placement_t drop =
+          drops[getRolloutRandom(random) % (uint64_t)count];
+      const Piece_t *piece = getPiece(type, drop.rotation);
+      int y = drop.y;
+
+      while (!isPieceCollide(&current, piece, drop.x, y + 1)) ++y;
+      value += placePiece(&current, piece, drop.x, y);
+    } else {
+      value -= ROLLOUT_PENALTY;
+      isOver = true;
+    }
+  }
+
+  return value;
+}
+
+void *runRolloutWorker(void *arg) {
+  RolloutWorker_t *worker = arg;
+  Rollout_t *rollout = worker->rollout;
+  unsigned long generation = 0;
+
+  pthread_mutex_lock(&rollout->mutex);
+  while (rollout->isActive) {
+    if (rollout->generation == generation) {
+      pthread_cond_wait(&rollout->start, &rollout->mutex);
+    } else {
+      generation = rollout->generation;
+      pthread_mutex_unlock(&rollout->mutex);
+
+      playRollouts(rollout, worker);
+
+      pthread_mutex_lock(&rollout->mutex);
+      if (--rollout->pending == 0) pthread_cond_signal(&rollout->done);
+    }
+  }
+  pthread_mutex_unlock(&rollout->mutex);
+
+  return NULL;
+}
+
+double getRolloutRate(const Rollout_t *rollout) {
+  return rollout->time > 0 ? (double)rollout->rollouts * 1e9 / rollout->time
+                           : 0.0;
+}
+
+void removeRollout(Rollout_t *rollout) {
+  pthread_mutex_lock(&rollout->mutex);
+  rollout->isActive = false;
+  pthread_cond_broadcast(&rollout->start);
+  pthread_mutex_unlock(&rollout->mutex);
+
+  for (int i = 0; i < rollout->threadsCount; ++i) {
+    if (i > 0) pthread_join(rollout->workers[i].thread, NULL);
+    free(rollout->workers[i].scratch);
+  }
+
+  pthread_mutex_destroy(&rollout->mutex);
+  pthread_cond_destroy(&rollout->start);
+  pthread_cond_destroy(&rollout->done);
+  rollout->threadsCount = 0;
+}
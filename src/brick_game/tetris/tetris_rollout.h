@@ -0,0 +1,187 @@
+#ifndef ROLLOUT_H
+#define ROLLOUT_H
+
+/*****************************************************************************
+ * @file tetris_rollout.h
+ * @brief Header File with Monte Carlo Rollout Search
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+
+#include "tetris_board.h"
+#include "tetris_logic.h"
+
+#define ROLLOUT_DEPTH 8
+#define ROLLOUT_THREADS_MAX 16
+#define ROLLOUT_PENALTY 8.0  // value lost by rollout that ends the game
+
+/*****************************************************************************
+ * @brief Rollout scratch struct
+ *
+ * Statistics of candidate placements collected by one worker
+ *
+ * @param values Sum of values of rollouts of every candidate
+ * @param counts Number of rollouts of every candidate
+ *****************************************************************************/
+typedef struct {
+  double values[PLACEMENTS_MAX];
+  unsigned long counts[PLACEMENTS_MAX];
+} RolloutScratch_t;
+
+typedef struct Rollout Rollout_t;
+
+/*****************************************************************************
+ * @brief Rollout worker struct
+ *
+ * @param thread Thread handle, worker 0 runs in thread of searchRollout
+ * @param index Index of worker
+ * @param rollout Rollout search the worker belongs to
+ * @param scratch Statistics of candidates collected by worker
+ * @param random State of PRNG of worker, never 0
+ *****************************************************************************/
+typedef struct {
+  pthread_t thread;
+  int index;
+  Rollout_t *rollout;
+  RolloutScratch_t *scratch;
+  uint64_t random;
+} RolloutWorker_t;
+
+/*****************************************************************************
+ * @brief Rollout struct
+ *
+ * Monte Carlo search without evaluation function. Every candidate placement
+ *of current figure is valued by mean rows removed in random games of depth
+ *figures played from its board. Every worker plays rollouts of all
+ *candidates with its own PRNG and searchRollout sums their statistics
+ *
+ * @param depth Number of figures of every rollout after candidate
+ * @param placements Candidate placements of current figure
+ * @param boards Boards after candidates
+ * @param lines Rows removed by candidates
+ * @param count Number of candidates
+ * @param typeNext Type of the first figure of every rollout
+ * @param deadline Monotonic time in ns to stop rollouts
+ * @param workers Workers of pool
+ * @param threadsCount Number of workers
+ * @param mutex Mutex of pool
+ * @param start Condition of new search
+ * @param done Condition of all workers done
+ * @param generation Number of searches given to workers
+ * @param pending Number of workers playing current search
+ * @param isActive Flag for activate worker threads
+ * @param rollouts Number of rollouts of all searches
+ * @param time Time of all searches in ns
+ *****************************************************************************/
+struct Rollout {
+  int depth;
+  Placement_t placements[PLACEMENTS_MAX];
+  Board_t boards[PLACEMENTS_MAX];
+  int lines[PLACEMENTS_MAX];
+  int count;
+  int typeNext;
+  long long deadline;
+  RolloutWorker_t workers[ROLLOUT_THREADS_MAX];
+  int threadsCount;
+  pthread_mutex_t mutex;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  unsigned long generation;
+  int pending;
+  bool isActive;
+  unsigned long long rollouts;
+  long long time;
+};
+
+/*****************************************************************************
+ * @brief Initialize rollout search
+ *
+ * Allocate scratch of workers, seed their PRNGs and start worker threads
+ *
+ * @param rollout Pointer to struct of Rollout_t
+ * @param depth Number of figures of every rollout
+ * @param threadsCount Number of workers, 0 for number of online CPUs
+ * @param seed Seed of PRNGs of workers
+ *****************************************************************************/
+void initializeRollout(Rollout_t *rollout, int depth, int threadsCount,
+                       uint64_t seed);
+
+/*****************************************************************************
+ * @brief Search rollouts
+ *
+ * Play rollouts of every candidate placement of current figure until
+ *deadline, at least one of every candidate by every worker, and choose the
+ *placement with the best mean value
+ *
+ * @param rollout Pointer to struct of Rollout_t
+ * @param board Pointer to board without current figure
+ * @param figure Pointer to current figure
+ * @param typeNext Type of next figure
+ * @param deadline Monotonic time in ns to stop rollouts
+ * @param placement Pointer to placement of current figure to fill
+ * @return unsigned long Number of rollouts played, 0 if figure has no
+ *placements
+ *****************************************************************************/
+unsigned long searchRollout(Rollout_t *rollout, const Board_t *board,
+                            const Figure_t *figure, int typeNext,
+                            long long deadline, Placement_t *placement);
+
+/*****************************************************************************
+ * @brief Play rollouts of worker
+ *
+ * Play sweeps of rollouts over all candidates until deadline
+ *
+ * @param rollout Pointer to struct of Rollout_t
+ * @param worker Pointer to struct of RolloutWorker_t
+ *****************************************************************************/
+void playRollouts(Rollout_t *rollout, RolloutWorker_t *worker);
+
+/*****************************************************************************
+ * @brief Play rollout
+ *
+ * Play random game on board: the first figure is of type, the next ones are
+ *random. Every figure is dropped from spawn row at random rotation and
+ *column, game ends when figure can't spawn or can't be dropped
+ *
+ * @param board Pointer to board to start with
+ * @param type Type of the first figure
+ * @param depth Number of figures
+ * @param random Pointer to state of PRNG
+ * @return double Rows removed, ROLLOUT_PENALTY less if game has ended
+ *****************************************************************************/
+double playRollout(const Board_t *board, int type, int depth,
+                   uint64_t *random);
+
+/*****************************************************************************
+ * @brief Rollout worker loop
+ *
+ * Thread routine: play every search given by searchRollout until rollout
+ *search is removed
+ *
+ * @param arg Pointer to struct of RolloutWorker_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *runRolloutWorker(void *arg);
+
+/*****************************************************************************
+ * @brief Get rollout rate
+ *
+ * @param rollout Pointer to struct of Rollout_t
+ * @return double Rollouts per second of all searches
+ *****************************************************************************/
+double getRolloutRate(const Rollout_t *rollout);
+
+/*****************************************************************************
+ * @brief Remove rollout search
+ *
+ * Stop and join worker threads and clear allocated memory
+ *
+ * @param rollout Pointer to struct of Rollout_t
+ *****************************************************************************/
+void removeRollout(Rollout_t *rollout);
+
+#endif  // ROLLOUT_H
@@ -0,0 +1,180 @@
+/*****************************************************************************
+ * @file tetris_sim.c
+ * @brief Source File with Headless Simulation of Many Tetris Games
+ *****************************************************************************/
+
+#include "tetris_sim.h"
+
+#include <unistd.h>
+
+void initializeSimulation(Simulation_t *simulation, int gamesCount,
+                          unsigned int seed) {
+  if (gamesCount < 1) gamesCount = 1;
+  if (gamesCount > SIM_GAMES_MAX) gamesCount = SIM_GAMES_MAX;
+
+  simulation->gamesCount = gamesCount;
+  simulation->threadsCount = 0;
+  simulation->spawnLimit = 0;
+  atomic_init(&simulation->isActive, false);
+
+  for (int i = 0; i < gamesCount; ++i) {
+    SimGame_t *game = &simulation->games[i];
+    game->parameters.data = &game->data;
+    game->parameters.figure = &game->figure;
+
+    initializeParametersPath(&game->parameters, NULL);
+    seedParameters(&game->parameters, seed + (unsigned int)i);
+
+    game->driverSeed = (seed + (unsigned int)i) * 2654435761u;
+    if (!game->driverSeed) game->driverSeed = 1;
+    game->isBot = false;
+    game->games = 0;
+    atomic_init(&game->isRequested, false);
+
+    processAction(&game->parameters, Start);
+    publishSnapshot(game);
+  }
+}
+
+void initializeSimulationBots(Simulation_t *simulation, long long budget) {
+  for (int i = 0; i < simulation->gamesCount; ++i) {
+    initializeBot(&simulation->games[i].bot, NULL, budget);
+    simulation->games[i].isBot = true;
+  }
+}
+
+void stepSimGame(SimGame_t *game) {
+  GameParameters_t *parameters = &game->parameters;
+
+  if (game->isBot) {
+    UserAction_t action;
+    unsigned long spawnCount = parameters->spawnCount;
+    while (parameters->state == GAME &&
+           parameters->spawnCount == spawnCount &&
+           (action = getBotAction(&game->bot, parameters)) != Up) {
+      processAction(parameters, action);
+    }
+  } else {
+    unsigned int r = getRandom(&game->driverSeed) % 16;
+
+    if (r < 4) {
+      processAction(parameters, Left);
+    } else if (r < 8) {
+      processAction(parameters, Right);
+    } else if (r < 11) {
+      processAction(parameters, Action);
+    } else if (r < 12) {
+      processAction(parameters, Down);
+    }
+  }
+
+  updateTicks(parameters, parameters->ticks + SIM_STEP_TICKS);
+
+  if (parameters->state == GAME_OVER) {
+    game->games++;
+    processAction(parameters, Start);
+  }
+
+  if (atomic_load_explicit(&game->isRequested, memory_order_acquire)) {
+    publishSnapshot(game);
+    atomic_store_explicit(&game->isRequested, false, memory_order_release);
+  }
+
+  // Stats dump reads counters of thread, so they are kept current every step
+  foldStats(&parameters->stats);
+}
+
+void publishSnapshot(SimGame_t *game) {
+  Snapshot_t *snapshot = &game->snapshot;
+
+  for (int row = 0; row < SNAPSHOT_ROWS; ++row) {
+    for (int col = 0; col < SNAPSHOT_COLS; ++col) {
+      snapshot->field[row][col] = (unsigned char)
+          game->data.field[row + BORDER_SIZE][col + BORDER_SIZE];
+    }
+  }
+
+  snapshot->score = game->data.score;
+  snapshot->level = game->data.level;
+  snapshot->games = game->games;
+}
+
+bool readSnapshot(SimGame_t *game, Snapshot_t *snapshot) {
+  bool isReady =
+      !atomic_load_explicit(&game->isRequested, memory_order_acquire);
+
+  if (isReady) {
+    *snapshot = game->snapshot;
+    atomic_store_explicit(&game->isRequested, true, memory_order_release);
+  }
+
+  return isReady;
+}
+
+void *runSimulation(void *arg) {
+  SimThread_t *thread = arg;
+  Simulation_t *simulation = thread->simulation;
+
+  bool isRunning = true;
+
+  while (isRunning &&
+         atomic_load_explicit(&simulation->isActive, memory_order_relaxed)) {
+    isRunning = false;
+
+    for (int i = thread->index; i < simulation->gamesCount;
+         i += simulation->threadsCount) {
+      SimGame_t *game = &simulation->games[i];
+
+      if (!simulation->spawnLimit ||
+          game->parameters.spawnCount < simulation->spawnLimit) {
+        stepSimGame(game);
+        isRunning = true;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+void startSimulation(Simulation_t *simulation, int threadsCount) {
+  if (threadsCount < 1) threadsCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threadsCount < 1) threadsCount = 1;
+  if (threadsCount > simulation->gamesCount) {
+    threadsCount = simulation->gamesCount;
+  }
+
+  simulation->threadsCount = threadsCount;
+  atomic_store(&simulation->isActive, true);
+
+  for (int i = 0; i < threadsCount; ++i) {
+    SimThread_t *thread = &simulation->threads[i];
+    thread->index = i;
+    thread->simulation = simulation;
+
+    if (pthread_create(&thread->thread, NULL, runSimulation, thread) != 0) {
+      printf("\nUnable to start simulation...\n");
+      exit(1);
+    }
+  }
+}
+
+void stopSimulation(Simulation_t *simulation) {
+  atomic_store(&simulation->isActive, false);
+  waitSimulation(simulation);
+}
+
+void waitSimulation(Simulation_t *simulation) {
+  for (int i = 0; i < simulation->threadsCount; ++i) {
+    pthread_join(simulation->threads[i].thread, NULL);
+  }
+
+  simulation->threadsCount = 0;
+}
+
+void removeSimulation(Simulation_t *simulation) {
+  for (int i = 0; i < simulation->gamesCount; ++i) {
+    removeParameters(&simulation->games[i].parameters);
+  }
+
+  simulation->gamesCount = 0;
+}
@@ -0,0 +1,213 @@
+#ifndef SIM_H
+#define SIM_H
+
+/*****************************************************************************
+ * @file tetris_sim.h
+ * @brief Header File with Headless Simulation of Many Tetris Games
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "tetris_bot.h"
+#include "tetris_logic.h"
+
+#define SIM_GAMES_MAX 64
+#define SIM_THREADS_MAX 64
+#define SIM_STEP_TICKS 10  // ticks per driver step
+#define SNAPSHOT_ROWS (FIELD_HEIGHT - BORDER_SIZE * 2)
+#define SNAPSHOT_COLS (FIELD_WIDTH - BORDER_SIZE * 2)
+
+/*****************************************************************************
+ * @brief Game snapshot struct
+ *
+ * Copy of visible game state for observers of running simulation
+ *
+ * @param field Visible field: 0 for empty pixel or figure type + 1
+ * @param score Current game score
+ * @param level Current game level
+ * @param games Number of finished games
+ *****************************************************************************/
+typedef struct {
+  unsigned char field[SNAPSHOT_ROWS][SNAPSHOT_COLS];
+  int score;
+  int level;
+  unsigned long games;
+} Snapshot_t;
+
+/*****************************************************************************
+ * @brief Simulated game struct
+ *
+ * One headless game with its driver and published snapshot. Driver is random
+ *or bot. Snapshot is
+ *written by simulation thread only when isRequested is set and read by
+ *observer only when it is cleared, so neither side ever waits for the other
+ *
+ * @param parameters Game parameters pointing to data and figure
+ * @param data Game data
+ * @param figure Current figure
+ * @param snapshot Last published snapshot
+ * @param isRequested Flag that observer waits for a new snapshot
+ * @param driverSeed State of random driver
+ * @param bot Bot driver
+ * @param isBot Flag that game is driven by bot
+ * @param games Number of finished games
+ *****************************************************************************/
+typedef struct {
+  GameParameters_t parameters;
+  GameInfo_t data;
+  Figure_t figure;
+  Snapshot_t snapshot;
+  atomic_bool isRequested;
+  unsigned int driverSeed;
+  Bot_t bot;
+  bool isBot;
+  unsigned long games;
+} SimGame_t;
+
+typedef struct Simulation Simulation_t;
+
+/*****************************************************************************
+ * @brief Simulation thread struct
+ *
+ * @param thread Thread handle
+ * @param index Index of thread: it steps games index, index + threadsCount...
+ * @param simulation Simulation the thread belongs to
+ *****************************************************************************/
+typedef struct {
+  pthread_t thread;
+  int index;
+  Simulation_t *simulation;
+} SimThread_t;
+
+/*****************************************************************************
+ * @brief Simulation struct
+ *
+ * Games simulated by a pool of threads, each thread steps every
+ *threadsCount-th game
+ *
+ * @param games Simulated games
+ * @param gamesCount Number of games
+ * @param threads Simulation threads
+ * @param threadsCount Number of threads
+ * @param spawnLimit Number of figures after which game stops, 0 for endless
+ * @param isActive Flag for activate simulation threads
+ *****************************************************************************/
+struct Simulation {
+  SimGame_t games[SIM_GAMES_MAX];
+  int gamesCount;
+  SimThread_t threads[SIM_THREADS_MAX];
+  int threadsCount;
+  unsigned long spawnLimit;
+  atomic_bool isActive;
+};
+
+/*****************************************************************************
+ * @brief Initialize simulation
+ *
+ * Initialize and start every game with its own seed. High score is kept in
+ *memory only
+ *
+ * @param simulation Pointer to struct of Simulation_t
+ * @param gamesCount Number of games: [1..SIM_GAMES_MAX]
+ * @param seed Seed of the first game, next games get next seeds
+ *****************************************************************************/
+void initializeSimulation(Simulation_t *simulation, int gamesCount,
+                          unsigned int seed);
+
+/*****************************************************************************
+ * @brief Drive simulation by bots
+ *
+ * Replace random driver of every game with bot
+ *
+ * @param simulation Pointer to initialized struct of Simulation_t
+ * @param budget Time of bot search per figure in ns
+ *****************************************************************************/
+void initializeSimulationBots(Simulation_t *simulation, long long budget);
+
+/*****************************************************************************
+ * @brief Step simulated game
+ *
+ * Apply actions of bot for at most one figure or one random driver action,
+ *advance logic clock by SIM_STEP_TICKS, restart game after game over,
+ *publish snapshot if requested and fold counters of game into counters of
+ *thread
+ *
+ * @param game Pointer to struct of SimGame_t
+ *****************************************************************************/
+void stepSimGame(SimGame_t *game);
+
+/*****************************************************************************
+ * @brief Publish snapshot
+ *
+ * Copy visible game state to snapshot. Called by simulation thread
+ *
+ * @param game Pointer to struct of SimGame_t
+ *****************************************************************************/
+void publishSnapshot(SimGame_t *game);
+
+/*****************************************************************************
+ * @brief Read snapshot
+ *
+ * Copy last published snapshot if it is ready and request a new one. Called
+ *by observer thread, never blocks simulation
+ *
+ * @param game Pointer to struct of SimGame_t
+ * @param snapshot Pointer to snapshot to fill
+ * @return bool False if requested snapshot is not published yet
+ *****************************************************************************/
+bool readSnapshot(SimGame_t *game, Snapshot_t *snapshot);
+
+/*****************************************************************************
+ * @brief Simulation thread loop
+ *
+ * Thread routine: step games of thread while simulation is active and some
+ *of them have not reached spawnLimit
+ *
+ * @param arg Pointer to struct of SimThread_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *runSimulation(void *arg);
+
+/*****************************************************************************
+ * @brief Start simulation
+ *
+ * Start simulation threads
+ *
+ * @param simulation Pointer to struct of Simulation_t
+ * @param threadsCount Number of threads, 0 for number of online CPUs
+ *****************************************************************************/
+void startSimulation(Simulation_t *simulation, int threadsCount);
+
+/*****************************************************************************
+ * @brief Stop simulation
+ *
+ * Stop and join simulation threads
+ *
+ * @param simulation Pointer to struct of Simulation_t
+ *****************************************************************************/
+void stopSimulation(Simulation_t *simulation);
+
+/*****************************************************************************
+ * @brief Wait simulation
+ *
+ * Join simulation threads after every game has reached spawnLimit
+ *
+ * @param simulation Pointer to struct of Simulation_t with spawnLimit set
+ *****************************************************************************/
+void waitSimulation(Simulation_t *simulation);
+
+/*****************************************************************************
+ * @brief Remove simulation
+ *
+ * Clear allocated memory of every game
+ *
+ * @param simulation Pointer to struct of Simulation_t
+ *****************************************************************************/
+void removeSimulation(Simulation_t *simulation);
+
+#endif  // SIM_H
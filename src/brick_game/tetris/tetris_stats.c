@@ -0,0 +1,175 @@
+/*****************************************************************************
+ * @file tetris_stats.c
+ * @brief Source File with Hot Path Counters of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_stats.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*****************************************************************************
+ * @brief Counters of thread struct
+ *
+ * Written only by its thread with relaxed stores, read by readStats
+ *
+ * @param values Counters folded by games of thread
+ * @param isRegistered Flag that counters are in list of threads
+ * @param next Next counters in list of threads
+ *****************************************************************************/
+typedef struct ThreadStats {
+  atomic_ullong values[STATS_COUNT];
+  bool isRegistered;
+  struct ThreadStats *next;
+} ThreadStats_t;
+
+static const char *statNames[STATS_COUNT] = {
+    "gravity_ticks",  "collide_checks", "failed_moves", "failed_rotations",
+    "pieces_locked",  "clears_1",       "clears_2",     "clears_3",
+    "clears_4",       "attach_ns",      "render_ns"};
+
+static _Thread_local ThreadStats_t threadStats;
+static ThreadStats_t *threadsList = NULL;
+static unsigned long long retiredValues[STATS_COUNT];
+static pthread_mutex_t statsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t statsKey;
+static pthread_once_t statsOnce = PTHREAD_ONCE_INIT;
+
+// Move counters of exiting thread to retired counters
+static void retireThreadStats(void *arg) {
+  ThreadStats_t *stats = arg;
+
+  pthread_mutex_lock(&statsMutex);
+  ThreadStats_t **link = &threadsList;
+  while (*link && *link != stats) link = &(*link)->next;
+  if (*link) *link = stats->next;
+
+  for (int i = 0; i < STATS_COUNT; ++i) {
+    retiredValues[i] +=
+        atomic_load_explicit(&stats->values[i], memory_order_relaxed);
+  }
+  pthread_mutex_unlock(&statsMutex);
+}
+
+static void initializeStatsKey(void) {
+  pthread_key_create(&statsKey, retireThreadStats);
+}
+
+static void registerThreadStats(void) {
+  pthread_once(&statsOnce, initializeStatsKey);
+
+  pthread_mutex_lock(&statsMutex);
+  threadStats.next = threadsList;
+  threadsList = &threadStats;
+  pthread_mutex_unlock(&statsMutex);
+
+  pthread_setspecific(statsKey, &threadStats);
+  threadStats.isRegistered = true;
+}
+
+void resetStats(Stats_t *stats) {
+  foldStats(stats);
+  memset(stats, 0, sizeof(*stats));
+}
+
+void foldStats(Stats_t *stats) {
+  if (!threadStats.isRegistered) registerThreadStats();
+
+  for (int i = 0; i < STATS_COUNT; ++i) {
+    unsigned long long delta = stats->values[i] - stats->folded[i];
+
+    // Only this thread writes, so load and store need no atomic addition
+    if (delta) {
+      atomic_store_explicit(
+          &threadStats.values[i],
+          atomic_load_explicit(&threadStats.values[i], memory_order_relaxed) +
+              delta,
+          memory_order_relaxed);
+      stats->folded[i] = stats->values[i];
+    }
+  }
+}
+
+void readStats(unsigned long long *values) {
+  pthread_mutex_lock(&statsMutex);
+  for (int i = 0; i < STATS_COUNT; ++i) values[i] = retiredValues[i];
+
+  for (ThreadStats_t *stats = threadsList; stats; stats = stats->next) {
+    for (int i = 0; i < STATS_COUNT; ++i) {
+      values[i] +=
+          atomic_load_explicit(&stats->values[i], memory_order_relaxed);
+    }
+  }
+  pthread_mutex_unlock(&statsMutex);
+}
+
+const char *getStatName(Stat_t stat) { return statNames[stat]; }
+
+long long getStatsTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+bool writeStats(const char *path) {
+  unsigned long long values[STATS_COUNT];
+  char temporary[STATS_PATH_SIZE + 4];
+  bool isValid = snprintf(temporary, sizeof(temporary), "%s.tmp", path) <
+                 (int)sizeof(temporary);
+
+  readStats(values);
+
+  FILE *file = isValid ? fopen(temporary, "w") : NULL;
+  isValid = file != NULL;
+
+  for (int i = 0; i < STATS_COUNT && isValid; ++i) {
+    isValid = fprintf(file, "%s %llu\n", statNames[i], values[i]) > 0;
+  }
+
+  if (file) isValid = fclose(file) == 0 && isValid;
+  if (isValid) isValid = rename(temporary, path) == 0;
+
+  return isValid;
+}
+
+void startStatsDumper(StatsDumper_t *dumper, const char *path) {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGUSR1);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  snprintf(dumper->path, sizeof(dumper->path), "%s", path);
+  atomic_init(&dumper->isActive, true);
+
+  if (pthread_create(&dumper->thread, NULL, runStatsDumper, dumper) != 0) {
+    printf("\nUnable to start stats dumper...\n");
+    exit(1);
+  }
+}
+
+void *runStatsDumper(void *arg) {
+  StatsDumper_t *dumper = arg;
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGUSR1);
+
+  int number;
+  while (sigwait(&signals, &number) == 0 &&
+         atomic_load_explicit(&dumper->isActive, memory_order_acquire)) {
+    if (!writeStats(dumper->path)) {
+      fprintf(stderr, "Error: Unable to write stats (%s)\n", dumper->path);
+    }
+  }
+
+  return NULL;
+}
+
+void stopStatsDumper(StatsDumper_t *dumper) {
+  atomic_store_explicit(&dumper->isActive, false, memory_order_release);
+  pthread_kill(dumper->thread, SIGUSR1);
+  pthread_join(dumper->thread, NULL);
+}
@@ -0,0 +1,151 @@
+#ifndef STATS_H
+#define STATS_H
+
+/*****************************************************************************
+ * @file tetris_stats.h
+ * @brief Header File with Hot Path Counters of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define STATS_PATH "./tetris.stats"
+#define STATS_PATH_SIZE 4096
+
+/*****************************************************************************
+ * @brief Hot path counters
+ *****************************************************************************/
+typedef enum {
+  STAT_GRAVITY_TICKS = 0,  // gravity shifts of figure
+  STAT_COLLIDE_CHECKS,     // calls of isFigureNotCollide
+  STAT_FAILED_MOVES,       // left and right moves into obstacle
+  STAT_FAILED_ROTATIONS,   // rotations into obstacle
+  STAT_PIECES_LOCKED,
+  STAT_CLEARS_1,  // locks removing 1 row
+  STAT_CLEARS_2,
+  STAT_CLEARS_3,
+  STAT_CLEARS_4,
+  STAT_ATTACH_NS,  // time of attachFigure
+  STAT_RENDER_NS,  // time of drawing frames
+  STATS_COUNT
+} Stat_t;
+
+/*****************************************************************************
+ * @brief Counters of game struct
+ *
+ * Kept by game and updated by plain increments in the thread that plays it.
+ *Values not yet added to counters of thread are values - folded
+ *
+ * @param values Counters since the game was started
+ * @param folded Part of values already added to counters of thread
+ *****************************************************************************/
+typedef struct {
+  unsigned long long values[STATS_COUNT];
+  unsigned long long folded[STATS_COUNT];
+} Stats_t;
+
+/*****************************************************************************
+ * @brief Stats dumper struct
+ *
+ * Thread that waits for SIGUSR1 and writes global counters to file, so
+ *threads playing games never stop for it
+ *
+ * @param thread Thread handle
+ * @param path Path of stats file
+ * @param isActive Flag that dumper waits for signals
+ *****************************************************************************/
+typedef struct {
+  pthread_t thread;
+  char path[STATS_PATH_SIZE];
+  atomic_bool isActive;
+} StatsDumper_t;
+
+/*****************************************************************************
+ * @brief Reset counters of game
+ *
+ * Fold values into counters of thread first, so global counters keep them
+ *
+ * @param stats Pointer to struct of Stats_t
+ *****************************************************************************/
+void resetStats(Stats_t *stats);
+
+/*****************************************************************************
+ * @brief Fold counters of game
+ *
+ * Add values not yet folded to counters of current thread. Thread registers
+ *its counters on the first fold and moves them to retired counters on exit
+ *
+ * @param stats Pointer to struct of Stats_t
+ *****************************************************************************/
+void foldStats(Stats_t *stats);
+
+/*****************************************************************************
+ * @brief Read global counters
+ *
+ * Sum counters of all threads and of exited ones
+ *
+ * @param values Array of STATS_COUNT counters to fill
+ *****************************************************************************/
+void readStats(unsigned long long *values);
+
+/*****************************************************************************
+ * @brief Get name of counter
+ *
+ * @param stat Counter
+ * @return const char* Name of counter
+ *****************************************************************************/
+const char *getStatName(Stat_t stat);
+
+/*****************************************************************************
+ * @brief Get time for counters
+ *
+ * @return long long Monotonic time in ns
+ *****************************************************************************/
+long long getStatsTime(void);
+
+/*****************************************************************************
+ * @brief Write global counters
+ *
+ * Write "name value" lines to temporary file and rename it over path, so
+ *readers never see a partial file
+ *
+ * @param path Path of stats file
+ * @return bool False if file can't be written
+ *****************************************************************************/
+bool writeStats(const char *path);
+
+/*****************************************************************************
+ * @brief Start stats dumper
+ *
+ * Block SIGUSR1 in calling thread and start thread that takes it with
+ *sigwait. Must be called before any other thread is started, so all of them
+ *inherit the blocked signal
+ *
+ * @param dumper Pointer to struct of StatsDumper_t
+ * @param path Path of stats file
+ *****************************************************************************/
+void startStatsDumper(StatsDumper_t *dumper, const char *path);
+
+/*****************************************************************************
+ * @brief Stats dumper thread loop
+ *
+ * Thread routine: write stats file on every SIGUSR1 until stopped
+ *
+ * @param arg Pointer to struct of StatsDumper_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *runStatsDumper(void *arg);
+
+/*****************************************************************************
+ * @brief Stop stats dumper
+ *
+ * @param dumper Pointer to struct of StatsDumper_t
+ *****************************************************************************/
+void stopStatsDumper(StatsDumper_t *dumper);
+
+#endif  // STATS_H
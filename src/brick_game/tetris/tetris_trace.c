@@ -0,0 +1,147 @@
+/*****************************************************************************
+ * @file tetris_trace.c
+ * @brief Source File with Chrome Trace Export of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tetris_stats.h"
+
+static atomic_bool isTracing = false;
+static atomic_uint traceGeneration = 1;
+static atomic_int threadsCount = 0;
+static _Atomic(TraceBuffer_t *) buffersList = NULL;
+static long long originTime = 0;
+
+// Buffer of thread is valid only for trace generation it was made for
+static _Thread_local TraceBuffer_t *threadBuffer = NULL;
+static _Thread_local unsigned threadGeneration = 0;
+
+static TraceBuffer_t *getThreadBuffer(void) {
+  unsigned generation =
+      atomic_load_explicit(&traceGeneration, memory_order_acquire);
+
+  if (threadGeneration != generation) {
+    TraceBuffer_t *buffer = malloc(sizeof(TraceBuffer_t));
+    if (buffer) {
+      buffer->events = malloc(sizeof(TraceEvent_t) * TRACE_EVENTS_MAX);
+    }
+
+    if (!buffer || !buffer->events) {
+      printf("\nNot enough memory...\n");
+      exit(1);
+    }
+
+    atomic_init(&buffer->count, 0);
+    buffer->dropped = 0;
+    buffer->tid = atomic_fetch_add(&threadsCount, 1) + 1;
+    buffer->name = NULL;
+    buffer->next = atomic_load_explicit(&buffersList, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&buffersList, &buffer->next,
+                                                  buffer, memory_order_release,
+                                                  memory_order_relaxed)) {
+    }
+
+    threadBuffer = buffer;
+    threadGeneration = generation;
+  }
+
+  return threadBuffer;
+}
+
+void startTrace(void) {
+  originTime = getStatsTime();
+  atomic_store_explicit(&isTracing, true, memory_order_release);
+}
+
+bool isTraceActive(void) {
+  return atomic_load_explicit(&isTracing, memory_order_relaxed);
+}
+
+long long beginTrace(void) { return isTraceActive() ? getStatsTime() : 0; }
+
+void endTrace(const char *name, long long begin) {
+  if (begin && isTraceActive()) {
+    TraceBuffer_t *buffer = getThreadBuffer();
+    size_t count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+
+    if (count < TRACE_EVENTS_MAX) {
+      buffer->events[count] = (TraceEvent_t){name, begin, getStatsTime()};
+      atomic_store_explicit(&buffer->count, count + 1, memory_order_release);
+    } else {
+      buffer->dropped++;
+    }
+  }
+}
+
+void nameTraceThread(const char *name) {
+  if (isTraceActive()) getThreadBuffer()->name = name;
+}
+
+bool writeTrace(const char *path) {
+  atomic_store_explicit(&isTracing, false, memory_order_release);
+
+  FILE *file = fopen(path, "w");
+  bool isValid = file != NULL;
+  size_t dropped = 0;
+  const char *separator = "\n";
+
+  if (isValid) isValid = fprintf(file, "{\"traceEvents\":[") > 0;
+
+  for (TraceBuffer_t *buffer =
+           atomic_load_explicit(&buffersList, memory_order_acquire);
+       buffer && isValid; buffer = buffer->next) {
+    size_t count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+    dropped += buffer->dropped;
+
+    if (buffer->name) {
+      isValid = fprintf(file,
+                        "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                        "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                        separator, buffer->tid, buffer->name) > 0;
+      separator = ",\n";
+    }
+
+    // Complete events: timestamp and duration in us from trace start
+    for (size_t i = 0; i < count && isValid; ++i) {
+      const TraceEvent_t *event = &buffer->events[i];
+      isValid = fprintf(file,
+                        "%s{\"name\":\"%s\",\"cat\":\"tetris\",\"ph\":\"X\","
+                        "\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        separator, event->name, buffer->tid,
+                        (event->begin - originTime) / 1000.0,
+                        (event->end - event->begin) / 1000.0) > 0;
+      separator = ",\n";
+    }
+  }
+
+  if (isValid) {
+    isValid = fprintf(file,
+                      "\n],\"displayTimeUnit\":\"ms\","
+                      "\"otherData\":{\"dropped\":\"%zu\"}}\n",
+                      dropped) > 0;
+  }
+
+  if (file) isValid = fclose(file) == 0 && isValid;
+
+  return isValid;
+}
+
+void removeTrace(void) {
+  atomic_store_explicit(&isTracing, false, memory_order_release);
+
+  TraceBuffer_t *buffer =
+      atomic_exchange_explicit(&buffersList, NULL, memory_order_acquire);
+  while (buffer) {
+    TraceBuffer_t *next = buffer->next;
+    free(buffer->events);
+    free(buffer);
+    buffer = next;
+  }
+
+  atomic_store(&threadsCount, 0);
+  atomic_fetch_add_explicit(&traceGeneration, 1, memory_order_release);
+}
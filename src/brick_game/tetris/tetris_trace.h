@@ -0,0 +1,114 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*****************************************************************************
+ * @file tetris_trace.h
+ * @brief Header File with Chrome Trace Export of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TRACE_EVENTS_MAX (1 << 17)  // Spans per thread, later ones are dropped
+
+/*****************************************************************************
+ * @brief Trace span struct
+ *
+ * @param name Static name of span
+ * @param begin Monotonic time of span begin in ns
+ * @param end Monotonic time of span end in ns
+ *****************************************************************************/
+typedef struct {
+  const char *name;
+  long long begin;
+  long long end;
+} TraceEvent_t;
+
+/*****************************************************************************
+ * @brief Trace buffer of thread struct
+ *
+ * Filled only by its thread, without locks. Buffers are linked into list of
+ *trace by atomic push when thread records its first span
+ *
+ * @param events Spans of thread
+ * @param count Number of recorded spans, published with release store
+ * @param dropped Number of spans not recorded because buffer was full
+ * @param tid Id of thread in trace
+ * @param name Static name of thread or NULL
+ * @param next Next buffer in list of trace
+ *****************************************************************************/
+typedef struct TraceBuffer {
+  TraceEvent_t *events;
+  atomic_size_t count;
+  size_t dropped;
+  int tid;
+  const char *name;
+  struct TraceBuffer *next;
+} TraceBuffer_t;
+
+/*****************************************************************************
+ * @brief Start trace
+ *
+ * Enable recording of spans by all threads
+ *****************************************************************************/
+void startTrace(void);
+
+/*****************************************************************************
+ * @brief Check trace
+ *
+ * @return bool True if spans are recorded
+ *****************************************************************************/
+bool isTraceActive(void);
+
+/*****************************************************************************
+ * @brief Begin span
+ *
+ * @return long long Monotonic time in ns, 0 if trace is not active
+ *****************************************************************************/
+long long beginTrace(void);
+
+/*****************************************************************************
+ * @brief End span
+ *
+ * Record span from begin to now into buffer of current thread. Span is
+ *ignored if trace is not active or begin is 0
+ *
+ * @param name Static name of span
+ * @param begin Monotonic time of span begin in ns
+ *****************************************************************************/
+void endTrace(const char *name, long long begin);
+
+/*****************************************************************************
+ * @brief Name current thread
+ *
+ * Name of thread shown by trace viewers, ignored if trace is not active
+ *
+ * @param name Static name of thread
+ *****************************************************************************/
+void nameTraceThread(const char *name);
+
+/*****************************************************************************
+ * @brief Write trace
+ *
+ * Stop trace and write spans of all threads in Chrome trace event JSON format,
+ *which is opened by chrome://tracing and Perfetto. Threads recording spans
+ *must have exited or stopped recording
+ *
+ * @param path Path of trace file
+ * @return bool False if file can't be written
+ *****************************************************************************/
+bool writeTrace(const char *path);
+
+/*****************************************************************************
+ * @brief Remove trace
+ *
+ * Stop trace and free buffers of all threads
+ *****************************************************************************/
+void removeTrace(void);
+
+#endif  // TRACE_H
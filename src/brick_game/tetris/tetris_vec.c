@@ -0,0 +1,301 @@
+/*****************************************************************************
+ * @file tetris_vec.c
+ * @brief Source File with Batched Environments of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_vec.h"
+
+#include <string.h>
+
+static const int rowsScores[PIECE_HEIGHT + 1] = {
+    0, SCORE_ROWS_1, SCORE_ROWS_2, SCORE_ROWS_3, SCORE_ROWS_4};
+
+static void *allocateVecArray(int count, size_t size) {
+  void *array = calloc((size_t)count, size);
+
+  if (NULL == array) {
+    printf("\nNot enough memory...\n");
+    exit(1);
+  }
+
+  return array;
+}
+
+static bool isVecCollide(const VecEnv_t *env, int index, int x, int y,
+                         int rotation) {
+  return isPieceCollide(&env->boards[index],
+                        getPiece(env->types[index], rotation), x, y);
+}
+
+static unsigned char getVecRandomType(VecEnv_t *env, int index) {
+  return (unsigned char)(getRandom(&env->seeds[index]) % FIGURES_COUNT);
+}
+
+// The same queue shift as spawnNextFigure
+static void spawnVecFigure(VecEnv_t *env, int index) {
+  unsigned char *queue = env->queues + index * (QUEUE_MAX - 1);
+  int last = env->queueLength - 2;
+
+  env->types[index] = env->typesNext[index];
+  if (last < 0) {
+    env->typesNext[index] = getVecRandomType(env, index);
+  } else {
+    env->typesNext[index] = queue[0];
+    memmove(queue, queue + 1, (size_t)last);
+    queue[last] = getVecRandomType(env, index);
+  }
+
+  env->xs[index] = FIELD_WIDTH / 2;
+  env->ys[index] = 2;
+  env->rotations[index] = 0;
+}
+
+// Attach figure and spawn the next one like attachFigure, score gain
+static int attachVecFigure(VecEnv_t *env, int index, bool *isOver) {
+  const Piece_t *piece = getPiece(env->types[index], env->rotations[index]);
+  int rows = placePiece(&env->boards[index], piece, env->xs[index],
+                        env->ys[index]);
+  int gain = rowsScores[rows];
+
+  env->scores[index] += gain;
+  env->ticks[index] = 0;
+  spawnVecFigure(env, index);
+
+  *isOver = isVecCollide(env, index, env->xs[index], env->ys[index] + 1,
+                         env->rotations[index]);
+  if (!*isOver) env->ys[index]++;
+
+  return gain;
+}
+
+// Set visible pixels of piece in plane to value
+static void drawVecPiece(const Piece_t *piece, int x, int y,
+                         unsigned char *plane, unsigned char value) {
+  for (int k = 0; k < piece->height; ++k) {
+    int row = y + piece->top + k - BORDER_SIZE;
+    int col = x + piece->left - BORDER_SIZE;
+
+    for (unsigned bits = piece->rows[k]; bits && row >= 0; bits >>= 1) {
+      if (bits & 1) plane[row * VEC_COLS + col] = value;
+      ++col;
+    }
+  }
+}
+
+// Set pixels of figure and of its ghost if requested in planes to value
+static void drawVecFigure(const Board_t *board, int type, int x, int y,
+                          int rotation, bool isGhost, unsigned char *planes,
+                          unsigned char value) {
+  const Piece_t *piece = getPiece(type, rotation);
+  int ghostY = y;
+
+  if (isGhost) {
+    while (!isPieceCollide(board, piece, x, ghostY + 1)) ++ghostY;
+    drawVecPiece(piece, x, ghostY,
+                 planes + VEC_PLANE_GHOST * VEC_OBSERVATION_SIZE, value);
+  }
+
+  drawVecPiece(piece, x, y, planes + VEC_PLANE_FIGURE * VEC_OBSERVATION_SIZE,
+               value);
+}
+
+void initializeVecEnv(VecEnv_t *env, int count, unsigned int seed,
+                      int gravity) {
+  if (count < 1) count = 1;
+
+  env->count = count;
+  env->gravity = gravity > 0 ? gravity : 0;
+  env->boards = allocateVecArray(count, sizeof(env->boards[0]));
+  env->types = allocateVecArray(count, sizeof(env->types[0]));
+  env->typesNext = allocateVecArray(count, sizeof(env->typesNext[0]));
+  env->xs = allocateVecArray(count, sizeof(env->xs[0]));
+  env->ys = allocateVecArray(count, sizeof(env->ys[0]));
+  env->rotations = allocateVecArray(count, sizeof(env->rotations[0]));
+  env->ticks = allocateVecArray(count, sizeof(env->ticks[0]));
+  env->scores = allocateVecArray(count, sizeof(env->scores[0]));
+  env->seeds = allocateVecArray(count, sizeof(env->seeds[0]));
+  env->games = allocateVecArray(count, sizeof(env->games[0]));
+  env->queues = allocateVecArray(count * (QUEUE_MAX - 1), 1);
+  env->queueLength = 1;
+  env->planes = NULL;
+  env->nextPlanes = NULL;
+
+  // The same sequence as seedParameters and startGame of game logic
+  for (int i = 0; i < count; ++i) {
+    env->seeds[i] = seed + (unsigned int)i;
+    if (!env->seeds[i]) env->seeds[i] = 1;
+    env->typesNext[i] = getVecRandomType(env, i);
+    resetVecGame(env, i);
+  }
+}
+
+void setVecQueueLength(VecEnv_t *env, int length) {
+  if (length < 1) length = 1;
+  if (length > QUEUE_MAX) length = QUEUE_MAX;
+
+  for (int i = 0; i < env->count; ++i) {
+    unsigned char *queue = env->queues + i * (QUEUE_MAX - 1);
+
+    for (int k = env->queueLength - 1; k < length - 1; ++k) {
+      queue[k] = getVecRandomType(env, i);
+    }
+  }
+
+  env->queueLength = length;
+
+  for (int i = 0; i < env->count && env->planes; ++i) {
+    writeVecPlanes(env, i, env->planes + i * VEC_PLANES_SIZE,
+                   env->nextPlanes + i * VEC_NEXT_SIZE);
+  }
+}
+
+void enableVecPlanes(VecEnv_t *env) {
+  if (NULL == env->planes) {
+    env->planes = allocateVecArray(env->count, VEC_PLANES_SIZE);
+    env->nextPlanes = allocateVecArray(env->count, VEC_NEXT_SIZE);
+  }
+
+  for (int i = 0; i < env->count; ++i) {
+    writeVecPlanes(env, i, env->planes + i * VEC_PLANES_SIZE,
+                   env->nextPlanes + i * VEC_NEXT_SIZE);
+  }
+}
+
+void resetVecGame(VecEnv_t *env, int index) {
+  resetBoard(&env->boards[index]);
+  env->ticks[index] = 0;
+  env->scores[index] = 0;
+  spawnVecFigure(env, index);
+}
+
+void stepVecEnv(VecEnv_t *env, const unsigned char *actions,
+                unsigned char *observations, float *rewards,
+                unsigned char *dones) {
+  for (int i = 0; i < env->count; ++i) {
+    int x = env->xs[i];
+    int y = env->ys[i];
+    int rotation = env->rotations[i];
+    int type = env->types[i];
+    int gain = 0;
+    bool isAttached = false;
+    bool isOver = false;
+
+    if (actions[i] == Left && !isVecCollide(env, i, x - 1, y, rotation)) {
+      env->xs[i]--;
+    } else if (actions[i] == Right &&
+               !isVecCollide(env, i, x + 1, y, rotation)) {
+      env->xs[i]++;
+    } else if (actions[i] == Action) {
+      int next = (rotation + 1) % ROTATIONS_COUNT;
+      if (!isVecCollide(env, i, x, y, next)) {
+        env->rotations[i] = (unsigned char)next;
+      }
+    } else if (actions[i] == Down) {
+      while (!isVecCollide(env, i, x, y + 1, rotation)) ++y;
+      env->ys[i] = (unsigned char)y;
+      gain = attachVecFigure(env, i, &isOver);
+      isAttached = true;
+    }
+
+    if (!isAttached && env->gravity && ++env->ticks[i] >= env->gravity) {
+      env->ticks[i] = 0;
+
+      if (isVecCollide(env, i, env->xs[i], env->ys[i] + 1,
+                       env->rotations[i])) {
+        gain = attachVecFigure(env, i, &isOver);
+        isAttached = true;
+      } else {
+        env->ys[i]++;
+      }
+    }
+
+    if (isOver) {
+      env->games[i]++;
+      resetVecGame(env, i);
+    }
+
+    unsigned char *planes = env->planes;
+    if (planes && isAttached) {
+      writeVecPlanes(env, i, planes + i * VEC_PLANES_SIZE,
+                     env->nextPlanes + i * VEC_NEXT_SIZE);
+    } else if (planes && (env->xs[i] != x || env->ys[i] != y ||
+                          env->rotations[i] != rotation)) {
+      // Board is the same, ghost moves only with column or rotation
+      bool isGhost = env->xs[i] != x || env->rotations[i] != rotation;
+
+      drawVecFigure(&env->boards[i], type, x, y, rotation, isGhost,
+                    planes + i * VEC_PLANES_SIZE, 0);
+      drawVecFigure(&env->boards[i], type, env->xs[i], env->ys[i],
+                    env->rotations[i], isGhost, planes + i * VEC_PLANES_SIZE,
+                    1);
+    }
+
+    if (observations) {
+      writeVecObservation(env, i, observations + i * VEC_OBSERVATION_SIZE);
+    }
+    if (rewards) rewards[i] = (float)gain;
+    if (dones) dones[i] = isOver;
+  }
+}
+
+void writeVecObservation(const VecEnv_t *env, int index,
+                         unsigned char *observation) {
+  const Board_t *board = &env->boards[index];
+  const Piece_t *piece = getPiece(env->types[index], env->rotations[index]);
+
+  for (int row = 0; row < VEC_ROWS; ++row) {
+    unsigned bits = board->rows[row + BORDER_SIZE] >> BORDER_SIZE;
+
+    for (int col = 0; col < VEC_COLS; ++col) {
+      observation[row * VEC_COLS + col] = bits >> col & 1;
+    }
+  }
+
+  drawVecPiece(piece, env->xs[index], env->ys[index], observation,
+               VEC_PIXEL_FIGURE);
+}
+
+void writeVecPlanes(const VecEnv_t *env, int index, unsigned char *planes,
+                    unsigned char *nextPlanes) {
+  const Board_t *board = &env->boards[index];
+  const unsigned char *queue = env->queues + index * (QUEUE_MAX - 1);
+
+  for (int row = 0; row < VEC_ROWS; ++row) {
+    unsigned bits = board->rows[row + BORDER_SIZE] >> BORDER_SIZE;
+
+    for (int col = 0; col < VEC_COLS; ++col) {
+      planes[VEC_PLANE_OCCUPANCY * VEC_OBSERVATION_SIZE + row * VEC_COLS +
+             col] = bits >> col & 1;
+    }
+  }
+
+  memset(planes + VEC_PLANE_FIGURE * VEC_OBSERVATION_SIZE, 0,
+         VEC_OBSERVATION_SIZE * 2);
+  drawVecFigure(board, env->types[index], env->xs[index], env->ys[index],
+                env->rotations[index], true, planes, 1);
+
+  memset(nextPlanes, 0, VEC_NEXT_SIZE);
+  for (int k = 0; k < env->queueLength; ++k) {
+    int type = k > 0 ? queue[k - 1] : env->typesNext[index];
+    nextPlanes[k * FIGURES_COUNT + type] = 1;
+  }
+}
+
+void removeVecEnv(VecEnv_t *env) {
+  free(env->boards);
+  free(env->types);
+  free(env->typesNext);
+  free(env->xs);
+  free(env->ys);
+  free(env->rotations);
+  free(env->ticks);
+  free(env->scores);
+  free(env->seeds);
+  free(env->games);
+  free(env->queues);
+  free(env->planes);
+  free(env->nextPlanes);
+  env->planes = NULL;
+  env->nextPlanes = NULL;
+  env->count = 0;
+}
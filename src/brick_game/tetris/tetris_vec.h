@@ -0,0 +1,173 @@
+#ifndef VEC_H
+#define VEC_H
+
+/*****************************************************************************
+ * @file tetris_vec.h
+ * @brief Header File with Batched Environments of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tetris_board.h"
+#include "tetris_logic.h"
+
+#define VEC_ROWS (FIELD_HEIGHT - BORDER_SIZE * 2)
+#define VEC_COLS (FIELD_WIDTH - BORDER_SIZE * 2)
+#define VEC_OBSERVATION_SIZE (VEC_ROWS * VEC_COLS)
+#define VEC_PIXEL_EMPTY 0
+#define VEC_PIXEL_FILLED 1
+#define VEC_PIXEL_FIGURE 2
+#define VEC_PLANE_OCCUPANCY 0  // filled pixels of board
+#define VEC_PLANE_FIGURE 1     // pixels of current figure
+#define VEC_PLANE_GHOST 2      // pixels of current figure after hard drop
+#define VEC_PLANES_COUNT 3
+#define VEC_PLANES_SIZE (VEC_PLANES_COUNT * VEC_OBSERVATION_SIZE)
+#define VEC_NEXT_SIZE (QUEUE_MAX * FIGURES_COUNT)
+
+/*****************************************************************************
+ * @brief Batched environments struct
+ *
+ * Games of the same rules as game logic kept as structure of arrays: every
+ *field is an array of count elements, game i is element i of every array.
+ *Boards replace int fields, so a step of game is a few row mask operations
+ *
+ * @param count Number of games
+ * @param gravity Number of steps per gravity shift, 0 for no gravity
+ * @param boards Boards without current figures
+ * @param types Types of current figures
+ * @param typesNext Types of next figures
+ * @param queues Types of upcoming figures after next ones: QUEUE_MAX - 1
+ *elements of every game
+ * @param queueLength Number of upcoming figures: [1..QUEUE_MAX]
+ * @param xs X coordinates of current figures
+ * @param ys Y coordinates of current figures
+ * @param rotations Rotations of current figures
+ * @param ticks Steps since the last gravity shift
+ * @param scores Scores of current games
+ * @param seeds Random seeds of figure sequences
+ * @param games Numbers of finished games
+ * @param planes Planes of every game or NULL: VEC_PLANES_COUNT planes of
+ *VEC_ROWS x VEC_COLS pixels of 0 or 1
+ * @param nextPlanes One-hot types of upcoming figures of every game or NULL:
+ *QUEUE_MAX rows of FIGURES_COUNT pixels, rows after queueLength are 0
+ *****************************************************************************/
+typedef struct {
+  int count;
+  int gravity;
+  Board_t *boards;
+  unsigned char *types;
+  unsigned char *typesNext;
+  unsigned char *queues;
+  int queueLength;
+  unsigned char *xs;
+  unsigned char *ys;
+  unsigned char *rotations;
+  int *ticks;
+  int *scores;
+  unsigned int *seeds;
+  unsigned long *games;
+  unsigned char *planes;
+  unsigned char *nextPlanes;
+} VecEnv_t;
+
+/*****************************************************************************
+ * @brief Initialize batched environments
+ *
+ * Allocate arrays and start every game with its own seed
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param count Number of games: at least 1
+ * @param seed Seed of the first game, next games get next seeds
+ * @param gravity Number of steps per gravity shift, 0 for no gravity
+ *****************************************************************************/
+void initializeVecEnv(VecEnv_t *env, int count, unsigned int seed,
+                      int gravity);
+
+/*****************************************************************************
+ * @brief Set number of upcoming figures
+ *
+ * The same as setQueueLength for every game
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param length Number of upcoming figures: [1..QUEUE_MAX]
+ *****************************************************************************/
+void setVecQueueLength(VecEnv_t *env, int length);
+
+/*****************************************************************************
+ * @brief Enable planes
+ *
+ * Allocate planes and next planes and keep them up to date on every step.
+ *They stay at the same address until removeVecEnv, so they can be wrapped
+ *without copying, e.g. as uint8 arrays of shape (count, VEC_PLANES_COUNT,
+ *VEC_ROWS, VEC_COLS) and (count, QUEUE_MAX, FIGURES_COUNT)
+ *
+ * @param env Pointer to struct of VecEnv_t
+ *****************************************************************************/
+void enableVecPlanes(VecEnv_t *env);
+
+/*****************************************************************************
+ * @brief Reset game of environments
+ *
+ * Clear board and score and spawn the next figure like startGame
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param index Index of game
+ *****************************************************************************/
+void resetVecGame(VecEnv_t *env, int index);
+
+/*****************************************************************************
+ * @brief Step environments
+ *
+ * Apply action to every game like processAction does: Left, Right, Action
+ *(rotation) and Down (hard drop), any other action waits. Then shift figure
+ *if gravity is due, attaching it if it can't fall. Finished games are reset
+ *at once, so their observations are of the new games. Enabled planes are
+ *updated only where figure or board has changed. Nothing is allocated
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param actions Array of count actions: values of UserAction_t
+ * @param observations Array of count * VEC_OBSERVATION_SIZE pixels to fill
+ *or NULL
+ * @param rewards Array of count score gains to fill or NULL
+ * @param dones Array of count flags of game over to fill or NULL
+ *****************************************************************************/
+void stepVecEnv(VecEnv_t *env, const unsigned char *actions,
+                unsigned char *observations, float *rewards,
+                unsigned char *dones);
+
+/*****************************************************************************
+ * @brief Write observation of game
+ *
+ * Visible field row by row: VEC_PIXEL_EMPTY, VEC_PIXEL_FILLED or
+ *VEC_PIXEL_FIGURE of current figure
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param index Index of game
+ * @param observation Array of VEC_OBSERVATION_SIZE pixels to fill
+ *****************************************************************************/
+void writeVecObservation(const VecEnv_t *env, int index,
+                         unsigned char *observation);
+
+/*****************************************************************************
+ * @brief Write planes of game
+ *
+ * @param env Pointer to struct of VecEnv_t
+ * @param index Index of game
+ * @param planes Array of VEC_PLANES_SIZE pixels to fill
+ * @param nextPlanes Array of VEC_NEXT_SIZE pixels to fill
+ *****************************************************************************/
+void writeVecPlanes(const VecEnv_t *env, int index, unsigned char *planes,
+                    unsigned char *nextPlanes);
+
+/*****************************************************************************
+ * @brief Remove batched environments
+ *
+ * Clear allocated memory
+ *
+ * @param env Pointer to struct of VecEnv_t
+ *****************************************************************************/
+void removeVecEnv(VecEnv_t *env);
+
+#endif  // VEC_H
@@ -0,0 +1,312 @@
+/*****************************************************************************
+ * @file tetris_ansi.c
+ * @brief GUI Direct ANSI Terminal Backend Source File
+ *****************************************************************************/
+
+#include "tetris_ansi.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define ANSI_GLYPH_BYTES 3  // UTF-8 length of every non-ASCII glyph
+
+/*****************************************************************************
+ * @brief UTF-8 glyphs
+ *
+ * UTF-8 encoding of AnsiGlyph_t, indexed from GLYPH_HLINE
+ *****************************************************************************/
+static const char *ansiGlyphs[] = {"─", "│", "┌", "┐", "└", "┘",
+                                   "┬", "┴", "←", "→", "↓"};
+
+static AnsiScreen_t ansi;
+
+void initAnsi(void) {
+  setlocale(LC_ALL, "");
+  tcgetattr(STDIN_FILENO, &ansi.termios);
+
+  struct termios raw = ansi.termios;
+  raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+  raw.c_cc[VMIN] = 1;
+  raw.c_cc[VTIME] = 0;
+  tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+  // Unknown glyphs force the first frame to be drawn completely
+  memset(ansi.screen, 0, sizeof(ansi.screen));
+  ansi.row = -1;
+  ansi.col = -1;
+  ansi.color = -1;
+
+  const char setup[] = "\x1b[?1049h\x1b[?25l\x1b[0m\x1b[2J";
+  writeAnsi(setup, sizeof(setup) - 1);
+}
+
+void drawAnsiFrame(GameParameters_t *parameters) {
+  long long traceTime = beginTrace();
+
+  if (parameters->state == START) {
+    drawAnsiStartScreen(parameters->data);
+    endTrace("drawAnsiStartScreen", traceTime);
+  } else if (parameters->state == GAME) {
+    drawAnsiGUI();
+    endTrace("drawAnsiGUI", traceTime);
+    traceTime = beginTrace();
+    drawAnsiInfo(parameters->data);
+    endTrace("drawAnsiInfo", traceTime);
+    traceTime = beginTrace();
+    drawAnsiField(parameters->data->field);
+    endTrace("drawAnsiField", traceTime);
+  } else if (parameters->state == GAME_OVER) {
+    drawAnsiGameOver(parameters->data);
+    endTrace("drawAnsiGameOver", traceTime);
+  }
+
+  if (parameters->data->pause) {
+    printAnsi(FIELD_SIZE_Y / 2 + 1, FIELD_SIZE_X - 1, "PAUSE");
+  }
+
+  traceTime = beginTrace();
+  flushAnsi();
+  endTrace("flushAnsi", traceTime);
+}
+
+void drawAnsiStartScreen(GameInfo_t *data) {
+  drawAnsiGUI();
+  drawAnsiInfo(data);
+
+  printAnsi(FIELD_SIZE_Y / 2 + 1, 1, "Press ENTER to start");
+}
+
+void drawAnsiGUI(void) {
+  for (int row = 0; row < ANSI_ROWS; ++row) {
+    for (int col = 0; col < ANSI_COLS; ++col) {
+      ansi.frame[row][col] = (AnsiCell_t){' ', 0};
+    }
+  }
+
+  int right = FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 2;
+  for (int col = 1; col < right; ++col) {
+    putAnsiCell(0, col, GLYPH_HLINE, 0);
+    putAnsiCell(FIELD_SIZE_Y + 1, col, GLYPH_HLINE, 0);
+  }
+
+  for (int col = 0; col < INFO_SIZE_X * 2; ++col) {
+    putAnsiCell(FIELD_SIZE_Y - 6, FIELD_SIZE_X * 2 + 2 + col, GLYPH_HLINE, 0);
+  }
+
+  for (int row = 1; row <= FIELD_SIZE_Y; ++row) {
+    putAnsiCell(row, 0, GLYPH_VLINE, 0);
+    putAnsiCell(row, FIELD_SIZE_X * 2 + 1, GLYPH_VLINE, 0);
+    putAnsiCell(row, right, GLYPH_VLINE, 0);
+  }
+
+  putAnsiCell(0, 0, GLYPH_ULCORNER, 0);
+  putAnsiCell(0, right, GLYPH_URCORNER, 0);
+  putAnsiCell(FIELD_SIZE_Y + 1, 0, GLYPH_LLCORNER, 0);
+  putAnsiCell(FIELD_SIZE_Y + 1, right, GLYPH_LRCORNER, 0);
+  putAnsiCell(0, FIELD_SIZE_X * 2 + 1, GLYPH_TTEE, 0);
+  putAnsiCell(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + 1, GLYPH_BTEE, 0);
+}
+
+void drawAnsiInfo(GameInfo_t *data) {
+  char text[ANSI_TEXT_SIZE];
+
+  const Analytics_t *analytics = &data->analytics;
+
+  snprintf(text, sizeof(text), "HIGH SCORE: %d", data->high_score);
+  printAnsi(2, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "SCORE: %d", data->score);
+  printAnsi(3, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "LEVEL: %d", data->level);
+  printAnsi(4, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "SPEED: %d", data->speed);
+  printAnsi(5, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "PPS %.2f APM %.0f",
+           getAnalyticsPps(analytics), getAnalyticsApm(analytics));
+  printAnsi(6, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "FAULTS: %lu", analytics->faults);
+  printAnsi(7, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "MAX HEIGHT: %d", analytics->maxHeight);
+  printAnsi(8, FIELD_SIZE_X * 2 + 3, text);
+  snprintf(text, sizeof(text), "CLEARS: %lu/%lu/%lu/%lu",
+           analytics->clears[0], analytics->clears[1], analytics->clears[2],
+           analytics->clears[3]);
+  printAnsi(9, FIELD_SIZE_X * 2 + 3, text);
+  printAnsi(10, FIELD_SIZE_X * 2 + 3, "NEXT:");
+  if (hint.isPcAvailable) {
+    printAnsi(13, FIELD_SIZE_X * 2 + 3, "PC AVAILABLE");
+  }
+
+  for (int row = 0; row < FIGURE_HEIGHT; ++row) {
+    for (int col = 0; col < FIGURE_WIDTH; ++col) {
+      if (data->next[row][col]) {
+        int x = FIELD_SIZE_X * 2 + 6 * 2 + col * 2;
+        putAnsiCell(row + 11, x, ' ', data->next[row][col]);
+        putAnsiCell(row + 11, x + 1, ' ', data->next[row][col]);
+      }
+    }
+  }
+
+  printAnsi(15, FIELD_SIZE_X * 2 + 4, "ESC  - Pause game");
+  putAnsiCell(16, FIELD_SIZE_X * 2 + 5, GLYPH_LARROW, 0);
+  printAnsi(16, FIELD_SIZE_X * 2 + 6, "   - Move left");
+  putAnsiCell(17, FIELD_SIZE_X * 2 + 5, GLYPH_RARROW, 0);
+  printAnsi(17, FIELD_SIZE_X * 2 + 6, "   - Move right");
+  putAnsiCell(18, FIELD_SIZE_X * 2 + 5, GLYPH_DARROW, 0);
+  printAnsi(18, FIELD_SIZE_X * 2 + 6, "   - Move down");
+  printAnsi(19, FIELD_SIZE_X * 2 + 3, "SPACE - Rotate");
+  printAnsi(20, FIELD_SIZE_X * 2 + 5, "Q   - Exit game");
+}
+
+void drawAnsiField(int **field) {
+  for (int row = 0; row < FIELD_SIZE_Y; ++row) {
+    for (int col = 0; col < FIELD_SIZE_X; ++col) {
+      if (field[row + 3][col + 3]) {
+        putAnsiCell(row + 1, col * 2 + 1, ' ', field[row + 3][col + 3]);
+        putAnsiCell(row + 1, col * 2 + 2, ' ', field[row + 3][col + 3]);
+      }
+    }
+  }
+}
+
+void drawAnsiGameOver(GameInfo_t *data) {
+  drawAnsiGUI();
+  drawAnsiInfo(data);
+  drawAnsiField(data->field);
+
+  printAnsi(FIELD_SIZE_Y / 2, 6, "GAME OVER");
+  printAnsi(FIELD_SIZE_Y / 2 + 1, 5, "Press ENTER");
+  printAnsi(FIELD_SIZE_Y / 2 + 2, 4, "to start again");
+}
+
+void putAnsiCell(int row, int col, unsigned char glyph, unsigned char color) {
+  if (row >= 0 && row < ANSI_ROWS && col >= 0 && col < ANSI_COLS) {
+    ansi.frame[row][col] = (AnsiCell_t){glyph, color};
+  }
+}
+
+void printAnsi(int row, int col, const char *text) {
+  for (int i = 0; text[i]; ++i) {
+    putAnsiCell(row, col + i, (unsigned char)text[i], 0);
+  }
+}
+
+void flushAnsi(void) {
+  ansi.length = 0;
+
+  for (int row = 0; row < ANSI_ROWS; ++row) {
+    for (int col = 0; col < ANSI_COLS; ++col) {
+      AnsiCell_t cell = ansi.frame[row][col];
+      AnsiCell_t shown = ansi.screen[row][col];
+
+      if (cell.glyph != shown.glyph || cell.color != shown.color) {
+        moveAnsiCursor(row, col);
+        appendAnsiCell(cell);
+        ansi.screen[row][col] = cell;
+      }
+    }
+  }
+
+  if (ansi.length > 0) {
+    writeAnsi(ansi.buffer, ansi.length);
+  }
+}
+
+void moveAnsiCursor(int row, int col) {
+  int gap = col - ansi.col;
+  bool isSameRow = ansi.row == row && gap >= 0;
+
+  // Unchanged cells in the same color are cheaper to rewrite than to skip
+  int rewriteLength = 0;
+  for (int c = ansi.col; isSameRow && c < col && rewriteLength >= 0; ++c) {
+    AnsiCell_t shown = ansi.screen[row][c];
+    int length = shown.glyph < 128 ? 1 : ANSI_GLYPH_BYTES;
+    rewriteLength = shown.glyph && shown.color == ansi.color
+                        ? rewriteLength + length
+                        : -1;
+  }
+
+  int skipLength = gap < 10 ? 4 : 5;
+  if (isSameRow && rewriteLength >= 0 && rewriteLength <= skipLength) {
+    for (int c = ansi.col; c < col; ++c) {
+      appendAnsiCell(ansi.screen[row][c]);
+    }
+  } else if (isSameRow) {
+    appendAnsi("\x1b[", 2);
+    appendAnsiNumber(gap);
+    appendAnsi("C", 1);
+  } else {
+    appendAnsi("\x1b[", 2);
+    appendAnsiNumber(row + 1);
+    appendAnsi(";", 1);
+    appendAnsiNumber(col + 1);
+    appendAnsi("H", 1);
+  }
+
+  ansi.row = row;
+  ansi.col = col;
+}
+
+void appendAnsiCell(AnsiCell_t cell) {
+  if (cell.color != ansi.color) {
+    if (cell.color) {
+      char sequence[] = "\x1b[40m";
+      sequence[3] = (char)('0' + figureColors[cell.color - 1]);
+      appendAnsi(sequence, sizeof(sequence) - 1);
+    } else {
+      appendAnsi("\x1b[49m", 5);
+    }
+
+    ansi.color = cell.color;
+  }
+
+  if (cell.glyph < 128) {
+    char glyph = (char)cell.glyph;
+    appendAnsi(&glyph, 1);
+  } else {
+    appendAnsi(ansiGlyphs[cell.glyph - GLYPH_HLINE], ANSI_GLYPH_BYTES);
+  }
+
+  ++ansi.col;
+}
+
+void appendAnsi(const char *bytes, int length) {
+  if (ansi.length + length <= ANSI_BUFFER_SIZE) {
+    memcpy(ansi.buffer + ansi.length, bytes, (size_t)length);
+    ansi.length += length;
+  }
+}
+
+void appendAnsiNumber(int number) {
+  char digits[12];
+  int length = 0;
+
+  do {
+    digits[sizeof(digits) - 1 - length++] = (char)('0' + number % 10);
+    number /= 10;
+  } while (number > 0);
+
+  appendAnsi(digits + sizeof(digits) - length, length);
+}
+
+void writeAnsi(const char *bytes, int length) {
+  while (length > 0) {
+    ssize_t written = write(STDOUT_FILENO, bytes, (size_t)length);
+
+    if (written > 0) {
+      bytes += written;
+      length -= (int)written;
+    } else if (written < 0 && errno != EINTR && errno != EAGAIN) {
+      length = 0;
+    }
+  }
+}
+
+void destroyAnsi(void) {
+  printAnsi(FIELD_SIZE_Y + 2, 2, "End of Game. Closing the application...");
+  flushAnsi();
+  sleep(2);
+
+  const char restore[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+  writeAnsi(restore, sizeof(restore) - 1);
+  tcsetattr(STDIN_FILENO, TCSANOW, &ansi.termios);
+}
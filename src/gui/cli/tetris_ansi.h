@@ -0,0 +1,213 @@
+#ifndef ANSI_H
+#define ANSI_H
+
+/*****************************************************************************
+ * @file tetris_ansi.h
+ * @brief GUI Direct ANSI Terminal Backend Header File
+ *****************************************************************************/
+
+#include "tetris_cli.h"
+
+#include <termios.h>
+
+#define ANSI_ROWS (FIELD_SIZE_Y + 3)
+#define ANSI_COLS (FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3)
+#define ANSI_CELL_BYTES 24  // Worst case: cursor move, color and glyph
+#define ANSI_BUFFER_SIZE (ANSI_ROWS * ANSI_COLS * ANSI_CELL_BYTES)
+#define ANSI_TEXT_SIZE 64
+
+/*****************************************************************************
+ * @brief Non-ASCII glyphs
+ *
+ * Codes of box drawing and arrow glyphs, stored in cells above ASCII range
+ *****************************************************************************/
+typedef enum {
+  GLYPH_HLINE = 128,
+  GLYPH_VLINE,
+  GLYPH_ULCORNER,
+  GLYPH_URCORNER,
+  GLYPH_LLCORNER,
+  GLYPH_LRCORNER,
+  GLYPH_TTEE,
+  GLYPH_BTEE,
+  GLYPH_LARROW,
+  GLYPH_RARROW,
+  GLYPH_DARROW
+} AnsiGlyph_t;
+
+/*****************************************************************************
+ * @brief Screen cell struct
+ *
+ * @param glyph ASCII char or AnsiGlyph_t, 0 for unknown terminal content
+ * @param color Background color: 0 for default or figure type + 1
+ *****************************************************************************/
+typedef struct {
+  unsigned char glyph;
+  unsigned char color;
+} AnsiCell_t;
+
+/*****************************************************************************
+ * @brief ANSI screen struct
+ *
+ * Frame being composed, frame shown by terminal and output buffer
+ *
+ * @param frame Cells of frame being composed
+ * @param screen Cells shown by terminal
+ * @param buffer Preallocated output buffer of one frame
+ * @param length Number of bytes in buffer
+ * @param row Terminal cursor row, -1 if unknown
+ * @param col Terminal cursor col, -1 if unknown
+ * @param color Terminal background color, -1 if unknown
+ * @param termios Terminal settings to restore
+ *****************************************************************************/
+typedef struct {
+  AnsiCell_t frame[ANSI_ROWS][ANSI_COLS];
+  AnsiCell_t screen[ANSI_ROWS][ANSI_COLS];
+  char buffer[ANSI_BUFFER_SIZE];
+  int length;
+  int row;
+  int col;
+  int color;
+  struct termios termios;
+} AnsiScreen_t;
+
+/*****************************************************************************
+ * @brief ANSI backend initialization
+ *
+ * Switch terminal to non-canonical mode and alternate screen
+ *****************************************************************************/
+void initAnsi(void);
+
+/*****************************************************************************
+ * @brief Draw ANSI frame
+ *
+ * Compose screen for current game state and flush changes to terminal
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void drawAnsiFrame(GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Draw start screen
+ *
+ * Compose static start screen
+ *****************************************************************************/
+void drawAnsiStartScreen(GameInfo_t *data);
+
+/*****************************************************************************
+ * @brief Draw GUI
+ *
+ * Clear frame and compose static part of GUI
+ *****************************************************************************/
+void drawAnsiGUI(void);
+
+/*****************************************************************************
+ * @brief Draw info block
+ *
+ * Compose info block with game data and preview with colored next figure
+ *****************************************************************************/
+void drawAnsiInfo(GameInfo_t *data);
+
+/*****************************************************************************
+ * @brief Draw field of game
+ *
+ * Compose colored field of game
+ *****************************************************************************/
+void drawAnsiField(int **field);
+
+/*****************************************************************************
+ * @brief Draw screen of game over
+ *
+ * Compose static screen of game over
+ *****************************************************************************/
+void drawAnsiGameOver(GameInfo_t *data);
+
+/*****************************************************************************
+ * @brief Put cell
+ *
+ * Put one cell to the frame being composed
+ *
+ * @param row Screen row
+ * @param col Screen col
+ * @param glyph ASCII char or AnsiGlyph_t
+ * @param color Background color: 0 for default or figure type + 1
+ *****************************************************************************/
+void putAnsiCell(int row, int col, unsigned char glyph, unsigned char color);
+
+/*****************************************************************************
+ * @brief Print text
+ *
+ * Put ASCII text to the frame being composed
+ *
+ * @param row Screen row
+ * @param col Screen col of the first char
+ * @param text Null-terminated ASCII text
+ *****************************************************************************/
+void printAnsi(int row, int col, const char *text);
+
+/*****************************************************************************
+ * @brief Flush frame
+ *
+ * Encode cells that differ from terminal content into output buffer with
+ *shortest cursor moves and color changes on transitions only, then write
+ *buffer with a single write()
+ *****************************************************************************/
+void flushAnsi(void);
+
+/*****************************************************************************
+ * @brief Move cursor
+ *
+ * Append the shortest cursor move to output buffer: rewrite of a few
+ *unchanged cells, cursor forward or cursor position
+ *
+ * @param row Screen row
+ * @param col Screen col
+ *****************************************************************************/
+void moveAnsiCursor(int row, int col);
+
+/*****************************************************************************
+ * @brief Append cell
+ *
+ * Append color change if needed and glyph of cell to output buffer
+ *
+ * @param cell Cell to append
+ *****************************************************************************/
+void appendAnsiCell(AnsiCell_t cell);
+
+/*****************************************************************************
+ * @brief Append bytes
+ *
+ * Append bytes to output buffer
+ *
+ * @param bytes Bytes to append
+ * @param length Number of bytes
+ *****************************************************************************/
+void appendAnsi(const char *bytes, int length);
+
+/*****************************************************************************
+ * @brief Append number
+ *
+ * Append decimal number to output buffer
+ *
+ * @param number Non-negative number
+ *****************************************************************************/
+void appendAnsiNumber(int number);
+
+/*****************************************************************************
+ * @brief Write bytes to terminal
+ *
+ * Write all bytes to stdout, retrying on partial writes
+ *
+ * @param bytes Bytes to write
+ * @param length Number of bytes
+ *****************************************************************************/
+void writeAnsi(const char *bytes, int length);
+
+/*****************************************************************************
+ * @brief ANSI backend destruction
+ *
+ * Restore terminal settings and leave alternate screen
+ *****************************************************************************/
+void destroyAnsi(void);
+
+#endif  // ANSI_H
@@ -5,27 +5,93 @@
 
 #include "tetris_cli.h"
 
+#include <string.h>
+
+#include "tetris_ansi.h"
+#include "tetris_viewer.h"
+
+const Renderer_t renderers[RENDERERS_COUNT] = {
+    {initGUI, drawFrame, destroyGUI},      // RENDERER_NCURSES
+    {initAnsi, drawAnsiFrame, destroyAnsi}  // RENDERER_ANSI
+};
+
+Hint_t hint = {NULL, 0, false};
+
+const short figureColors[FIGURES_COUNT] = {
+    COLOR_BLUE,     // Hero
+    COLOR_CYAN,     // Blue Ricky
+    COLOR_GREEN,    // Orange Ricky
+    COLOR_MAGENTA,  // SmashBoy
+    COLOR_RED,      // Rhode Island Z
+    COLOR_WHITE,    // TeeWee
+    COLOR_YELLOW    // Cleveland Z
+};
+
+static Windows_t windows;
+
+bool parseOptions(int argc, char *argv[], Options_t *options) {
+  bool isValid = true;
+  options->renderer = RENDERER_NCURSES;
+  options->viewGames = 0;
+  options->isBot = false;
+  options->queueLength = 1;
+  options->isRollout = false;
+  options->isHint = false;
+  options->tracePath = NULL;
+
+  for (int i = 1; i < argc && isValid; ++i) {
+    if (strcmp(argv[i], "--ansi") == 0) {
+      options->renderer = RENDERER_ANSI;
+    } else if (strcmp(argv[i], "--bot") == 0) {
+      options->isBot = true;
+    } else if (strcmp(argv[i], "--rollout") == 0) {
+      options->isBot = true;
+      options->isRollout = true;
+    } else if (strcmp(argv[i], "--hint") == 0) {
+      options->isHint = true;
+    } else if (strcmp(argv[i], "--next") == 0 && i + 1 < argc) {
+      options->queueLength = atoi(argv[++i]);
+      isValid = options->queueLength > 0 && options->queueLength <= QUEUE_MAX;
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      options->tracePath = argv[++i];
+    } else if (strcmp(argv[i], "--view") == 0 && i + 1 < argc) {
+      options->viewGames = atoi(argv[++i]);
+      isValid = options->viewGames > 0 && options->viewGames <= SIM_GAMES_MAX;
+    } else {
+      isValid = false;
+    }
+  }
+
+  return isValid;
+}
+
 void initGUI(void) {
   setlocale(LC_ALL, "");
   initscr();
   start_color();
 
-  init_pair(1, COLOR_BLUE, COLOR_BLUE);
-  init_pair(2, COLOR_CYAN, COLOR_CYAN);
-  init_pair(3, COLOR_GREEN, COLOR_GREEN);
-  init_pair(4, COLOR_MAGENTA, COLOR_MAGENTA);
-  init_pair(5, COLOR_RED, COLOR_RED);
-  init_pair(6, COLOR_WHITE, COLOR_WHITE);
-  init_pair(7, COLOR_YELLOW, COLOR_YELLOW);
+  for (int color = 0; color < FIGURES_COUNT; ++color) {
+    init_pair(color + 1, figureColors[color], figureColors[color]);
+  }
 
   cbreak();
   noecho();
   curs_set(0);
   keypad(stdscr, true);
-  timeout(READ_DELAY);
+
+  windows.field = newwin(FIELD_SIZE_Y, FIELD_SIZE_X * 2, 1, 1);
+  windows.stats =
+      newwin(FIELD_SIZE_Y - 7, INFO_SIZE_X * 2, 1, FIELD_SIZE_X * 2 + 2);
+  windows.help =
+      newwin(6, INFO_SIZE_X * 2, FIELD_SIZE_Y - 5, FIELD_SIZE_X * 2 + 2);
+  windows.state = -1;
+  windows.isInfoValid = false;
+
+  drawGUI();
+  doupdate();
 }
 
-void gameLoop(void) {
+void gameLoop(const Renderer_t *renderer, int queueLength, Bot_t *bot) {
   GameParameters_t parameters;
   GameInfo_t data;
   parameters.data = &data;
@@ -33,57 +99,184 @@ void gameLoop(void) {
   parameters.figure = &figure;
   UserAction_t action;
   bool hold = false;
-  double counter = 0.;
+  InputReader_t reader;
+  InputEvent_t event;
 
   initializeParameters(&parameters);
+  parameters.analyticsPath = ANALYTICS_PATH;
+  setQueueLength(&parameters, queueLength);
   updateParameters(&parameters);
 
+  long long startTime = getMonotonicTime();
+  long long frameTime = startTime;
+  nameTraceThread("game");
+  startInputReader(&reader);
+
   while (parameters.isActive) {
-    if (counter >= 1.6 - parameters.data->speed * SPEED_RATE) {
-      if (parameters.state == GAME && !parameters.data->pause) {
-        updateCurrentState();
+    while (parameters.isActive && popInputEvent(&reader.queue, &event)) {
+      updateTicks(&parameters, getTick(startTime, event.time));
+
+      action = getAction(event.key);
+      if (action != Up) {
+        long long traceTime = beginTrace();
+        userInput(action, hold);
+        endTrace("userInput", traceTime);
+      }
+    }
+
+    if (parameters.isActive) {
+      updateTicks(&parameters, getTick(startTime, getMonotonicTime()));
+
+      // Bot places at most one figure per frame
+      unsigned long spawnCount = parameters.spawnCount;
+      long long traceTime = beginTrace();
+      while (bot && parameters.spawnCount == spawnCount &&
+             (action = getBotAction(bot, &parameters)) != Up) {
+        userInput(action, false);
       }
+      if (bot) endTrace("bot", traceTime);
 
-      counter = 0.;
+      traceTime = beginTrace();
+      updateHint(&hint, &parameters);
+      if (hint.pc) endTrace("hint", traceTime);
+
+      long long renderTime = getStatsTime();
+      renderer->drawFrame(&parameters);
+      parameters.stats.values[STAT_RENDER_NS] += getStatsTime() - renderTime;
+      endTrace("drawFrame", renderTime);
     }
 
-    counter += READ_DELAY * 0.001;
+    // Stats dump reads counters of thread, so they are kept current per frame
+    foldStats(&parameters.stats);
 
-    if (parameters.state == START) {
-      drawStartScreen(parameters.data);
-    } else if (parameters.state == GAME) {
-      drawGUI();
-      drawInfo(parameters.data);
-      drawField(parameters.data->field);
-    } else if (parameters.state == GAME_OVER) {
-      drawGameOver(parameters.data);
+    frameTime += (long long)(READ_DELAY * NSEC_PER_MSEC);
+    struct timespec wakeTime = {.tv_sec = frameTime / NSEC_PER_SEC,
+                                .tv_nsec = frameTime % NSEC_PER_SEC};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime, NULL);
+  }
+
+  stopInputReader(&reader);
+}
+
+void updateHint(Hint_t *hint, GameParameters_t *parameters) {
+  if (hint->pc && hint->spawnCount != parameters->spawnCount) {
+    Board_t board;
+    Placement_t solution[PC_PIECES_MAX];
+    int types[QUEUE_MAX];
+
+    for (int i = 0; i < parameters->queueLength; ++i) {
+      types[i] = getQueuedFigure(parameters, i);
     }
 
-    if (parameters.data->pause) {
-      mvprintw(FIELD_SIZE_Y / 2 + 1, FIELD_SIZE_X - 1, "PAUSE");
-      move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
+    initializeBoard(&board, parameters->data->field, parameters->figure);
+    hint->spawnCount = parameters->spawnCount;
+    hint->isPcAvailable =
+        parameters->state == GAME &&
+        solvePerfectClear(hint->pc, &board, parameters->figure, types,
+                          parameters->queueLength,
+                          getMonotonicTime() + PC_BUDGET, solution) > 0;
+  }
+}
+
+unsigned long getTick(long long startTime, long long time) {
+  return (unsigned long)((time - startTime) / (NSEC_PER_SEC / TICK_RATE));
+}
+
+void drawFrame(GameParameters_t *parameters) {
+  bool isScreenChanged = (int)parameters->state != windows.state ||
+                         parameters->data->pause != windows.pause;
+  windows.state = parameters->state;
+  windows.pause = parameters->data->pause;
+
+  if (updateFieldCache(parameters->data->field) || isScreenChanged) {
+    werase(windows.field);
+
+    long long traceTime = beginTrace();
+    if (parameters->state == START) {
+      drawStartScreen(parameters->data);
+      endTrace("drawStartScreen", traceTime);
+    } else if (parameters->state == GAME) {
+      drawField(parameters->data->field);
+      endTrace("drawField", traceTime);
+    } else if (parameters->state == GAME_OVER) {
+      drawGameOver(parameters->data);
+      endTrace("drawGameOver", traceTime);
     }
 
-    int pressedKey = getch();
-    action = getAction(pressedKey);
-    if (action != Up) {
-      userInput(action, hold);
+    if (parameters->data->pause) {
+      mvwprintw(windows.field, FIELD_SIZE_Y / 2, FIELD_SIZE_X - 2, "PAUSE");
     }
+
+    wnoutrefresh(windows.field);
+  }
+
+  if (updateInfoCache(parameters->data)) {
+    long long traceTime = beginTrace();
+    drawInfo(parameters->data);
+    endTrace("drawInfo", traceTime);
+    wnoutrefresh(windows.stats);
   }
+
+  long long traceTime = beginTrace();
+  doupdate();
+  endTrace("doupdate", traceTime);
 }
 
-void drawStartScreen(GameInfo_t *data) {
-  drawGUI();
-  drawInfo(data);
+bool updateFieldCache(int **field) {
+  bool isChanged = false;
 
-  mvprintw(FIELD_SIZE_Y / 2 + 1, 1, "Press ENTER to start");
+  for (int row = 0; row < FIELD_SIZE_Y; ++row) {
+    for (int col = 0; col < FIELD_SIZE_X; ++col) {
+      if (windows.fieldCache[row][col] != field[row + 3][col + 3]) {
+        windows.fieldCache[row][col] = field[row + 3][col + 3];
+        isChanged = true;
+      }
+    }
+  }
 
-  move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
+  return isChanged;
 }
 
-void drawGUI(void) {
-  clear();
+bool updateInfoCache(GameInfo_t *data) {
+  bool isChanged = !windows.isInfoValid ||
+                   windows.info.high_score != data->high_score ||
+                   windows.info.score != data->score ||
+                   windows.info.level != data->level ||
+                   windows.info.speed != data->speed ||
+                   windows.isPcAvailable != hint.isPcAvailable ||
+                   isAnalyticsChanged(&windows.info.analytics,
+                                      &data->analytics);
+
+  for (int row = 0; row < FIGURE_HEIGHT; ++row) {
+    for (int col = 0; col < FIGURE_WIDTH; ++col) {
+      if (windows.nextCache[row][col] != data->next[row][col]) {
+        windows.nextCache[row][col] = data->next[row][col];
+        isChanged = true;
+      }
+    }
+  }
+
+  windows.info = *data;
+  windows.isInfoValid = true;
+  windows.isPcAvailable = hint.isPcAvailable;
+
+  return isChanged;
+}
+
+bool isAnalyticsChanged(const Analytics_t *shown,
+                        const Analytics_t *analytics) {
+  return shown->pieces != analytics->pieces ||
+         shown->actions != analytics->actions ||
+         shown->ticks / TICK_RATE != analytics->ticks / TICK_RATE;
+}
+
+void drawStartScreen(GameInfo_t *data) {
+  (void)data;
+
+  mvwprintw(windows.field, FIELD_SIZE_Y / 2, 0, "Press ENTER to start");
+}
 
+void drawGUI(void) {
   mvhline(0, 0, ACS_HLINE, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 2);
   mvhline(FIELD_SIZE_Y + 1, 0, ACS_HLINE,
           FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 2);
@@ -100,62 +293,68 @@ void drawGUI(void) {
           ACS_LRCORNER);
   mvaddch(0, FIELD_SIZE_X * 2 + 1, ACS_TTEE);
   mvaddch(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + 1, ACS_BTEE);
-
-  move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
+  wnoutrefresh(stdscr);
+
+  mvwprintw(windows.help, 0, 2, "ESC  - Pause game");
+  mvwaddwstr(windows.help, 1, 3, L"←   - Move left");
+  mvwaddwstr(windows.help, 2, 3, L"→   - Move right");
+  mvwaddwstr(windows.help, 3, 3, L"↓   - Move down");
+  mvwprintw(windows.help, 4, 1, "SPACE - Rotate");
+  mvwprintw(windows.help, 5, 3, "Q   - Exit game");
+  wnoutrefresh(windows.help);
 }
 
 void drawInfo(GameInfo_t *data) {
-  mvprintw(2, FIELD_SIZE_X * 2 + 3, "HIGH SCORE: %d", data->high_score);
-  mvprintw(4, FIELD_SIZE_X * 2 + 3, "SCORE: %d", data->score);
-  mvprintw(6, FIELD_SIZE_X * 2 + 3, "LEVEL: %d", data->level);
-  mvprintw(8, FIELD_SIZE_X * 2 + 3, "SPEED: %d", data->speed);
-  mvprintw(10, FIELD_SIZE_X * 2 + 3, "NEXT:");
+  werase(windows.stats);
+
+  const Analytics_t *analytics = &data->analytics;
+  mvwprintw(windows.stats, 1, 1, "HIGH SCORE: %d", data->high_score);
+  mvwprintw(windows.stats, 2, 1, "SCORE: %d", data->score);
+  mvwprintw(windows.stats, 3, 1, "LEVEL: %d", data->level);
+  mvwprintw(windows.stats, 4, 1, "SPEED: %d", data->speed);
+  mvwprintw(windows.stats, 5, 1, "PPS %.2f APM %.0f",
+            getAnalyticsPps(analytics), getAnalyticsApm(analytics));
+  mvwprintw(windows.stats, 6, 1, "FAULTS: %lu", analytics->faults);
+  mvwprintw(windows.stats, 7, 1, "MAX HEIGHT: %d", analytics->maxHeight);
+  mvwprintw(windows.stats, 8, 1, "CLEARS: %lu/%lu/%lu/%lu",
+            analytics->clears[0], analytics->clears[1], analytics->clears[2],
+            analytics->clears[3]);
+  mvwprintw(windows.stats, 9, 1, "NEXT:");
+  if (hint.isPcAvailable) {
+    mvwprintw(windows.stats, 12, 1, "PC AVAILABLE");
+  }
 
   for (int row = 0; row < FIGURE_HEIGHT; ++row) {
     for (int col = 0; col < FIGURE_WIDTH; ++col) {
       if (data->next[row][col]) {
-        attron(COLOR_PAIR(data->next[row][col]));
-        mvaddch(row + 11, FIELD_SIZE_X * 2 + 6 * 2 + col * 2, ACS_CKBOARD);
-        mvaddch(row + 11, FIELD_SIZE_X * 2 + 6 * 2 + col * 2 + 1, ACS_CKBOARD);
-        attroff(COLOR_PAIR(data->next[row][col]));
+        wattron(windows.stats, COLOR_PAIR(data->next[row][col]));
+        mvwaddch(windows.stats, row + 10, 6 * 2 - 2 + col * 2, ACS_CKBOARD);
+        mvwaddch(windows.stats, row + 10, 6 * 2 - 1 + col * 2, ACS_CKBOARD);
+        wattroff(windows.stats, COLOR_PAIR(data->next[row][col]));
       }
     }
   }
-
-  mvprintw(15, FIELD_SIZE_X * 2 + 4, "ESC  - Pause game");
-  mvaddwstr(16, FIELD_SIZE_X * 2 + 5, L"←   - Move left");
-  mvaddwstr(17, FIELD_SIZE_X * 2 + 5, L"→   - Move right");
-  mvaddwstr(18, FIELD_SIZE_X * 2 + 5, L"↓   - Move down");
-  mvprintw(19, FIELD_SIZE_X * 2 + 3, "SPACE - Rotate");
-  mvprintw(20, FIELD_SIZE_X * 2 + 5, "Q   - Exit game");
-  move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
 }
 
 void drawField(int **field) {
   for (int row = 0; row < FIELD_SIZE_Y; ++row) {
     for (int col = 0; col < FIELD_SIZE_X; ++col) {
       if (field[row + 3][col + 3]) {
-        attron(COLOR_PAIR(field[row + 3][col + 3]));
-        mvaddch(row + 1, col * 2 + 1, ACS_CKBOARD);
-        mvaddch(row + 1, col * 2 + 2, ACS_CKBOARD);
-        attroff(COLOR_PAIR(field[row + 3][col + 3]));
+        wattron(windows.field, COLOR_PAIR(field[row + 3][col + 3]));
+        mvwaddch(windows.field, row, col * 2, ACS_CKBOARD);
+        mvwaddch(windows.field, row, col * 2 + 1, ACS_CKBOARD);
+        wattroff(windows.field, COLOR_PAIR(field[row + 3][col + 3]));
       }
     }
   }
-
-  move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
 }
 
 void drawGameOver(GameInfo_t *data) {
-  drawGUI();
-  drawInfo(data);
   drawField(data->field);
 
-  mvprintw(FIELD_SIZE_Y / 2, 6, "GAME OVER");
-  mvprintw(FIELD_SIZE_Y / 2 + 1, 5, "Press ENTER");
-  mvprintw(FIELD_SIZE_Y / 2 + 2, 4, "to start again");
-
-  move(FIELD_SIZE_Y + 1, FIELD_SIZE_X * 2 + INFO_SIZE_X * 2 + 3);
+  mvwprintw(windows.field, FIELD_SIZE_Y / 2 - 1, 5, "GAME OVER");
+  mvwprintw(windows.field, FIELD_SIZE_Y / 2, 4, "Press ENTER");
+  mvwprintw(windows.field, FIELD_SIZE_Y / 2 + 1, 3, "to start again");
 }
 
 UserAction_t getAction(int pressedKey) {
@@ -190,6 +389,10 @@ UserAction_t getAction(int pressedKey) {
 }
 
 void destroyGUI(void) {
+  delwin(windows.field);
+  delwin(windows.stats);
+  delwin(windows.help);
+
   mvprintw(FIELD_SIZE_Y + 2, 2, "End of Game. Closing the application...");
   refresh();
   sleep(2);
@@ -7,68 +7,271 @@
  *****************************************************************************/
 
 #define _XOPEN_SOURCE_EXTENDED
+#define _POSIX_C_SOURCE 200809L
 
 #include <locale.h>
 #include <ncurses.h>
 #include <unistd.h>
 #include <wchar.h>
 
+#include "../../brick_game/tetris/tetris_bot.h"
 #include "../../brick_game/tetris/tetris_logic.h"
+#include "../../brick_game/tetris/tetris_trace.h"
+#include "tetris_input.h"
 
 #define FIELD_SIZE_X 10
 #define FIELD_SIZE_Y 20
 #define INFO_SIZE_X 10
 #define INFO_SIZE_Y 20
-#define SPEED_RATE 0.16
 #define FRAME_RATE 60     // Hz
 #define READ_DELAY 16.67  // ms
+#define RENDERERS_COUNT 2
+
+/*****************************************************************************
+ * @brief Renderer types
+ *
+ * Terminal backends, used as index in renderers table
+ *****************************************************************************/
+typedef enum { RENDERER_NCURSES = 0, RENDERER_ANSI } RendererType_t;
+
+/*****************************************************************************
+ * @brief Renderer struct
+ *
+ * Terminal backend functions
+ *
+ * @param init Initialize terminal
+ * @param drawFrame Draw whole frame for current game state
+ * @param destroy Restore terminal
+ *****************************************************************************/
+typedef struct {
+  void (*init)(void);
+  void (*drawFrame)(GameParameters_t *parameters);
+  void (*destroy)(void);
+} Renderer_t;
+
+/*****************************************************************************
+ * @brief Command line options struct
+ *
+ * @param renderer Terminal backend
+ * @param viewGames Number of simulated games to view, 0 to play
+ * @param isBot Flag that games are played by bot
+ * @param queueLength Number of upcoming figures: [1..QUEUE_MAX]
+ * @param isRollout Flag that bot uses Monte Carlo rollouts
+ * @param isHint Flag that perfect clear hint is shown and played by bot
+ * @param tracePath Path of Chrome trace written on exit or NULL for no trace
+ *****************************************************************************/
+typedef struct {
+  RendererType_t renderer;
+  int viewGames;
+  bool isBot;
+  int queueLength;
+  bool isRollout;
+  bool isHint;
+  const char *tracePath;
+} Options_t;
+
+/*****************************************************************************
+ * @brief Hint struct
+ *
+ * Hints shown by renderers, updated once per figure
+ *
+ * @param pc Perfect clear solver or NULL for no hints
+ * @param spawnCount Spawn count of game the hints are made for
+ * @param isPcAvailable Flag that known figures can clear the board
+ *****************************************************************************/
+typedef struct {
+  PerfectClear_t *pc;
+  unsigned long spawnCount;
+  bool isPcAvailable;
+} Hint_t;
+
+/*****************************************************************************
+ * @brief ncurses windows struct
+ *
+ * Persistent windows of ncurses backend with content they show. Border
+ *(stdscr) and help are static and drawn once, field and stats are redrawn
+ *only when their content changes
+ *
+ * @param field Window of game field
+ * @param stats Window of game data and next figure
+ * @param help Window of controls help
+ * @param fieldCache Visible field shown in field window
+ * @param nextCache Next figure shown in stats window
+ * @param info Game data shown in stats window
+ * @param isInfoValid Flag that info is shown
+ * @param isPcAvailable Perfect clear hint shown in stats window
+ * @param state Game state shown in field window
+ * @param pause Pause flag shown in field window
+ *****************************************************************************/
+typedef struct {
+  WINDOW *field;
+  WINDOW *stats;
+  WINDOW *help;
+  int fieldCache[FIELD_SIZE_Y][FIELD_SIZE_X];
+  int nextCache[FIGURE_HEIGHT][FIGURE_WIDTH];
+  GameInfo_t info;
+  bool isInfoValid;
+  bool isPcAvailable;
+  int state;
+  int pause;
+} Windows_t;
+
+/*****************************************************************************
+ * @brief Renderers table
+ *
+ * Terminal backends indexed by RendererType_t
+ *****************************************************************************/
+extern const Renderer_t renderers[RENDERERS_COUNT];
+
+/*****************************************************************************
+ * @brief Colors of figures
+ *
+ * Terminal color of every figure type, shared by all backends
+ *****************************************************************************/
+extern const short figureColors[FIGURES_COUNT];
+
+/*****************************************************************************
+ * @brief Hints of game
+ *
+ * Hints of game played by gameLoop, shared by all backends
+ *****************************************************************************/
+extern Hint_t hint;
+
+/*****************************************************************************
+ * @brief Parse command line options
+ *
+ * Parse command line options: --ansi selects direct ANSI backend, --view N
+ *shows N simulated games instead of playing, --bot lets bot play, --next N
+ *sets number of upcoming figures searched by bot, --rollout lets bot play
+ *by Monte Carlo rollouts, --hint shows if perfect clear is available,
+ *--trace PATH writes spans of game loop to Chrome trace on exit
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Pointer to struct of Options_t to fill
+ * @return bool False if there is unknown option or invalid number of games
+ *****************************************************************************/
+bool parseOptions(int argc, char *argv[], Options_t *options);
 
 /*****************************************************************************
  * @brief GUI initialization
  *
- * Initialize ncurses CLI window, settings and colors
+ * Initialize ncurses CLI windows, settings and colors and draw static part of
+ *GUI
  *****************************************************************************/
 void initGUI(void);
 
 /*****************************************************************************
  * @brief Main loop of game
  *
- * Main loop of game with drawing screens and processing user input
+ * Main loop of game with drawing screens and processing user input events in
+ *the order they were read by input reader. Logic runs on its own fixed-step
+ *clock, frames are drawn at FRAME_RATE at most. Bot, if any, acts through
+ *userInput after user input and places at most one figure per frame
+ *
+ * @param renderer Pointer to terminal backend
+ * @param queueLength Number of upcoming figures: [1..QUEUE_MAX]
+ * @param bot Pointer to struct of Bot_t or NULL to play by user
+ *****************************************************************************/
+void gameLoop(const Renderer_t *renderer, int queueLength, Bot_t *bot);
+
+/*****************************************************************************
+ * @brief Update hints
+ *
+ * Solve perfect clear once per spawned figure if hint has a solver
+ *
+ * @param hint Pointer to struct of Hint_t
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void updateHint(Hint_t *hint, GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Get logic tick
+ *
+ * Convert monotonic time to tick of logic clock
+ *
+ * @param startTime Monotonic time of logic clock start in ns
+ * @param time Monotonic time in ns
+ * @return unsigned long Logic clock tick
+ *****************************************************************************/
+unsigned long getTick(long long startTime, long long time);
+
+/*****************************************************************************
+ * @brief Draw frame
+ *
+ * Redraw windows whose content changed for current game state and refresh
+ *them with a single doupdate()
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ *****************************************************************************/
+void drawFrame(GameParameters_t *parameters);
+
+/*****************************************************************************
+ * @brief Update field cache
+ *
+ * Copy visible field to the cache of field window
+ *
+ * @param field Game field with borders
+ * @return bool True if visible field has changed
+ *****************************************************************************/
+bool updateFieldCache(int **field);
+
+/*****************************************************************************
+ * @brief Update info cache
+ *
+ * Copy game data and next figure to the cache of stats window
+ *
+ * @param data Game data
+ * @return bool True if game data or next figure has changed
+ *****************************************************************************/
+bool updateInfoCache(GameInfo_t *data);
+
+/*****************************************************************************
+ * @brief Check analytics
+ *
+ * Faults, clears and height change only with pieces, rates change with
+ *actions and are redrawn at least once per second of game
+ *
+ * @param shown Pointer to analytics shown in stats window
+ * @param analytics Pointer to analytics of game
+ * @return bool True if shown analytics are outdated
  *****************************************************************************/
-void gameLoop(void);
+bool isAnalyticsChanged(const Analytics_t *shown,
+                        const Analytics_t *analytics);
 
 /*****************************************************************************
  * @brief Draw start screen
  *
- * Draw static start screen
+ * Draw static start screen into field window
  *****************************************************************************/
 void drawStartScreen(GameInfo_t *data);
 
 /*****************************************************************************
  * @brief Draw GUI
  *
- * Draw static part of GUI
+ * Draw static part of GUI: borders and controls help. Called once
  *****************************************************************************/
 void drawGUI(void);
 
 /*****************************************************************************
  * @brief Draw info block
  *
- * Draw info block with game data and preview with colored next figure
+ * Draw info block with game data and preview with colored next figure into
+ *stats window
  *****************************************************************************/
 void drawInfo(GameInfo_t *data);
 
 /*****************************************************************************
  * @brief Draw field of game
  *
- * Draw colored field of game
+ * Draw colored field of game into field window
  *****************************************************************************/
 void drawField(int **field);
 
 /*****************************************************************************
  * @brief Draw screen of game over
  *
- * Draw static screen of game over
+ * Draw static screen of game over into field window
  *****************************************************************************/
 void drawGameOver(GameInfo_t *data);
 
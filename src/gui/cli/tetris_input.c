@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * @file tetris_input.c
+ * @brief Source File with Input Reader of the Tetris Game
+ *****************************************************************************/
+
+#include "tetris_input.h"
+
+#include <ncurses.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../../brick_game/tetris/tetris_trace.h"
+
+long long getMonotonicTime(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+void initializeInputQueue(InputQueue_t *queue) {
+  atomic_init(&queue->head, 0);
+  atomic_init(&queue->tail, 0);
+}
+
+bool pushInputEvent(InputQueue_t *queue, const InputEvent_t *event) {
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+  bool canPush = tail - head < INPUT_QUEUE_SIZE;
+
+  if (canPush) {
+    queue->events[tail & (INPUT_QUEUE_SIZE - 1)] = *event;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+  }
+
+  return canPush;
+}
+
+bool popInputEvent(InputQueue_t *queue, InputEvent_t *event) {
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+  bool canPop = head != tail;
+
+  if (canPop) {
+    *event = queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+  }
+
+  return canPop;
+}
+
+// Wait for one byte for at most timeout ms
+static bool readByte(int fd, int timeout, unsigned char *byte) {
+  struct pollfd pfd = {.fd = fd, .events = POLLIN};
+
+  return poll(&pfd, 1, timeout) > 0 && read(fd, byte, 1) == 1;
+}
+
+int readKey(int fd, int timeout, int *pending, long long *time) {
+  unsigned char byte;
+  int key = ERR;
+
+  if (*pending != ERR) {
+    key = *pending;
+    *pending = ERR;
+    *time = getMonotonicTime();
+  } else if (readByte(fd, timeout, &byte)) {
+    key = byte;
+    *time = getMonotonicTime();
+  }
+
+  if (key == '\r') key = '\n';
+
+  if (key == 27 && readByte(fd, ESCAPE_DELAY, &byte)) {
+    unsigned char final;
+
+    if ((byte == '[' || byte == 'O') && readByte(fd, ESCAPE_DELAY, &final)) {
+      // Skip parameters of CSI sequence up to its final byte, every byte is
+      // waited for, so truncated sequence is dropped instead of blocking
+      bool isRead = true;
+      while (isRead && final >= '0' && final <= '?') {
+        isRead = readByte(fd, ESCAPE_DELAY, &final);
+      }
+
+      switch (isRead ? final : 0) {
+        case 'A':
+          key = KEY_UP;
+          break;
+        case 'B':
+          key = KEY_DOWN;
+          break;
+        case 'C':
+          key = KEY_RIGHT;
+          break;
+        case 'D':
+          key = KEY_LEFT;
+          break;
+        default:
+          key = ERR;
+      }
+    } else if (byte != '[' && byte != 'O') {
+      // ESC is Pause and byte is the next key pressed right after it
+      *pending = byte;
+    }
+  }
+
+  return key;
+}
+
+void *readInput(void *arg) {
+  InputReader_t *reader = arg;
+  int pending = ERR;
+  nameTraceThread("input");
+
+  while (atomic_load_explicit(&reader->isActive, memory_order_relaxed)) {
+    InputEvent_t event;
+    event.key =
+        readKey(STDIN_FILENO, INPUT_POLL_DELAY, &pending, &event.time);
+
+    // Span from the first byte of key, escape sequences wait for the rest
+    if (event.key != ERR) {
+      pushInputEvent(&reader->queue, &event);
+      endTrace("input read", event.time);
+    }
+  }
+
+  return NULL;
+}
+
+void startInputReader(InputReader_t *reader) {
+  initializeInputQueue(&reader->queue);
+  atomic_init(&reader->isActive, true);
+
+  if (pthread_create(&reader->thread, NULL, readInput, reader) != 0) {
+    printf("\nUnable to start input reader...\n");
+    exit(1);
+  }
+}
+
+void stopInputReader(InputReader_t *reader) {
+  atomic_store(&reader->isActive, false);
+  pthread_join(reader->thread, NULL);
+}
@@ -0,0 +1,154 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+/*****************************************************************************
+ * @file tetris_input.h
+ * @brief Header File with Input Reader of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#define INPUT_QUEUE_SIZE 256  // Must be a power of two
+#define INPUT_POLL_DELAY 50   // ms
+#define ESCAPE_DELAY 25       // ms
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_MSEC 1000000LL
+
+/*****************************************************************************
+ * @brief Input event struct
+ *
+ * Key pressed by user with the moment it was read
+ *
+ * @param time Monotonic time of key read in nanoseconds
+ * @param key Keyboard button char or ncurses key code
+ *****************************************************************************/
+typedef struct {
+  long long time;
+  int key;
+} InputEvent_t;
+
+/*****************************************************************************
+ * @brief Input event queue
+ *
+ * Wait-free single-producer/single-consumer ring of input events. Only the
+ *input reader writes tail and only the game loop writes head
+ *
+ * @param events Ring buffer of events
+ * @param head Index of the next event to pop
+ * @param tail Index of the next free slot to push
+ *****************************************************************************/
+typedef struct {
+  InputEvent_t events[INPUT_QUEUE_SIZE];
+  atomic_size_t head;
+  atomic_size_t tail;
+} InputQueue_t;
+
+/*****************************************************************************
+ * @brief Input reader struct
+ *
+ * Input reader thread with its event queue
+ *
+ * @param queue Queue of events read from terminal
+ * @param thread Reader thread
+ * @param isActive Flag for activate reader loop
+ *****************************************************************************/
+typedef struct {
+  InputQueue_t queue;
+  pthread_t thread;
+  atomic_bool isActive;
+} InputReader_t;
+
+/*****************************************************************************
+ * @brief Get monotonic time
+ *
+ * Get current time of monotonic clock
+ *
+ * @return long long Time in nanoseconds
+ *****************************************************************************/
+long long getMonotonicTime(void);
+
+/*****************************************************************************
+ * @brief Initialize input queue
+ *
+ * Make input queue empty
+ *
+ * @param queue Pointer to struct of InputQueue_t
+ *****************************************************************************/
+void initializeInputQueue(InputQueue_t *queue);
+
+/*****************************************************************************
+ * @brief Push event to input queue
+ *
+ * Push event to the tail of queue. Must be called by producer only
+ *
+ * @param queue Pointer to struct of InputQueue_t
+ * @param event Pointer to event to push
+ * @return bool False if queue is full and event is dropped
+ *****************************************************************************/
+bool pushInputEvent(InputQueue_t *queue, const InputEvent_t *event);
+
+/*****************************************************************************
+ * @brief Pop event from input queue
+ *
+ * Pop event from the head of queue. Must be called by consumer only
+ *
+ * @param queue Pointer to struct of InputQueue_t
+ * @param event Pointer to event to fill
+ * @return bool False if queue is empty
+ *****************************************************************************/
+bool popInputEvent(InputQueue_t *queue, InputEvent_t *event);
+
+/*****************************************************************************
+ * @brief Read key from terminal
+ *
+ * Read one key from file descriptor and decode arrow escape sequences into
+ *ncurses key codes. Byte that follows ESC within ESCAPE_DELAY and doesn't
+ *start a sequence is kept in pending and returned by the next call.
+ *Sequence cut off for ESCAPE_DELAY is dropped
+ *
+ * @param fd Terminal file descriptor
+ * @param timeout Time to wait for key in ms
+ * @param pending Pointer to byte read ahead or ERR, must be ERR initially
+ * @param time Pointer to monotonic time of the first byte of key
+ * @return int Key code or ERR if no key was read
+ *****************************************************************************/
+int readKey(int fd, int timeout, int *pending, long long *time);
+
+/*****************************************************************************
+ * @brief Input reader loop
+ *
+ * Thread routine: read keys while reader is active
+ *
+ * @param arg Pointer to struct of InputReader_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *readInput(void *arg);
+
+/*****************************************************************************
+ * @brief Start input reader
+ *
+ * Start thread that reads keys from stdin, timestamps them and pushes into
+ *reader queue
+ *
+ * @param reader Pointer to struct of InputReader_t
+ *****************************************************************************/
+void startInputReader(InputReader_t *reader);
+
+/*****************************************************************************
+ * @brief Stop input reader
+ *
+ * Stop and join input reader thread
+ *
+ * @param reader Pointer to struct of InputReader_t
+ *****************************************************************************/
+void stopInputReader(InputReader_t *reader);
+
+#endif  // INPUT_H
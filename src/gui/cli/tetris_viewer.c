@@ -0,0 +1,140 @@
+/*****************************************************************************
+ * @file tetris_viewer.c
+ * @brief GUI Tiled Viewer of Headless Simulation Source File
+ *****************************************************************************/
+
+#include "tetris_viewer.h"
+
+#include <string.h>
+
+static Viewer_t viewer;
+
+void viewerLoop(int gamesCount, bool isBot) {
+  initializeSimulation(&viewer.simulation, gamesCount, (unsigned int)rand());
+  if (isBot) initializeSimulationBots(&viewer.simulation, BOT_BUDGET);
+  startSimulation(&viewer.simulation, 0);
+
+  viewer.page = 0;
+  layoutViewer(&viewer);
+
+  bool isActive = true;
+  while (isActive) {
+    drawViewer(&viewer);
+
+    int perPage = viewer.tilesX * viewer.tilesY;
+    int pages = (viewer.simulation.gamesCount + perPage - 1) / perPage;
+
+    switch (getch()) {
+      case 'q':
+      case 'Q':
+        isActive = false;
+        break;
+      case KEY_LEFT:
+        viewer.page = (viewer.page + pages - 1) % pages;
+        layoutViewer(&viewer);
+        break;
+      case KEY_RIGHT:
+        viewer.page = (viewer.page + 1) % pages;
+        layoutViewer(&viewer);
+        break;
+      case KEY_RESIZE:
+        layoutViewer(&viewer);
+        break;
+    }
+  }
+
+  stopSimulation(&viewer.simulation);
+  removeSimulation(&viewer.simulation);
+}
+
+void initViewer(void) {
+  setlocale(LC_ALL, "");
+  initscr();
+  start_color();
+
+  for (int lower = 0; lower < TILE_COLORS; ++lower) {
+    for (int upper = 0; upper < TILE_COLORS; ++upper) {
+      if (upper != lower) {
+        init_pair(getTilePair(upper, lower), getPixelColor(upper),
+                  getPixelColor(lower));
+      }
+    }
+  }
+
+  cbreak();
+  noecho();
+  curs_set(0);
+  keypad(stdscr, true);
+  timeout(VIEWER_DELAY);
+}
+
+void layoutViewer(Viewer_t *viewer) {
+  viewer->tilesX = COLS / TILE_WIDTH > 0 ? COLS / TILE_WIDTH : 1;
+  viewer->tilesY =
+      (LINES - 1) / TILE_HEIGHT > 0 ? (LINES - 1) / TILE_HEIGHT : 1;
+
+  int perPage = viewer->tilesX * viewer->tilesY;
+  int pages = (viewer->simulation.gamesCount + perPage - 1) / perPage;
+  if (viewer->page >= pages) viewer->page = pages - 1;
+
+  memset(viewer->isShown, 0, sizeof(viewer->isShown));
+
+  erase();
+  mvprintw(0, 0, "GAMES: %d  PAGE: %d/%d", viewer->simulation.gamesCount,
+           viewer->page + 1, pages);
+  addwstr(L"  ←/→ - Page  Q - Exit");
+}
+
+void drawViewer(Viewer_t *viewer) {
+  int perPage = viewer->tilesX * viewer->tilesY;
+  int first = viewer->page * perPage;
+
+  for (int i = first; i < first + perPage && i < viewer->simulation.gamesCount;
+       ++i) {
+    Snapshot_t snapshot;
+
+    if (readSnapshot(&viewer->simulation.games[i], &snapshot) &&
+        (!viewer->isShown[i] ||
+         memcmp(&snapshot, &viewer->snapshots[i], sizeof(snapshot)) != 0)) {
+      int tile = i - first;
+      viewer->snapshots[i] = snapshot;
+      viewer->isShown[i] = true;
+
+      drawTile(i, 1 + tile / viewer->tilesX * TILE_HEIGHT,
+               tile % viewer->tilesX * TILE_WIDTH, &snapshot);
+    }
+  }
+
+  refresh();
+}
+
+void drawTile(int index, int row, int col, const Snapshot_t *snapshot) {
+  mvprintw(row, col, "%2d %7d", index + 1, snapshot->score);
+
+  for (int y = 0; y < SNAPSHOT_ROWS / 2; ++y) {
+    for (int x = 0; x < SNAPSHOT_COLS; ++x) {
+      int upper = snapshot->field[y * 2][x];
+      int lower = snapshot->field[y * 2 + 1][x];
+
+      attron(COLOR_PAIR(getTilePair(upper, lower)));
+      mvaddwstr(row + 1 + y, col + x, upper == lower ? L" " : L"▀");
+      attroff(COLOR_PAIR(getTilePair(upper, lower)));
+    }
+  }
+}
+
+int getTilePair(int upper, int lower) {
+  if (upper == lower) upper = lower ? 0 : 1;
+
+  return 1 + lower * (TILE_COLORS - 1) + (upper < lower ? upper : upper - 1);
+}
+
+short getPixelColor(int pixel) {
+  return pixel ? figureColors[pixel - 1] : COLOR_BLACK;
+}
+
+void destroyViewer(void) {
+  clear();
+  refresh();
+  endwin();
+}
@@ -0,0 +1,119 @@
+#ifndef VIEWER_H
+#define VIEWER_H
+
+/*****************************************************************************
+ * @file tetris_viewer.h
+ * @brief GUI Tiled Viewer of Headless Simulation Header File
+ *****************************************************************************/
+
+#include "tetris_cli.h"
+
+#include "../../brick_game/tetris/tetris_sim.h"
+
+#define VIEWER_RATE 10                    // Hz
+#define VIEWER_DELAY (1000 / VIEWER_RATE)  // ms
+#define TILE_WIDTH (SNAPSHOT_COLS + 1)
+#define TILE_HEIGHT (SNAPSHOT_ROWS / 2 + 2)
+#define TILE_COLORS (FIGURES_COUNT + 1)
+
+/*****************************************************************************
+ * @brief Viewer struct
+ *
+ * Tiles of simulated games shown by viewer. Every field pixel takes half of
+ *a terminal cell, so tile is SNAPSHOT_COLS wide and SNAPSHOT_ROWS / 2 high
+ *with a label row above
+ *
+ * @param simulation Simulated games
+ * @param snapshots Snapshots shown in tiles
+ * @param isShown Flag that tile of game shows its snapshot
+ * @param tilesX Number of tiles in a row of page
+ * @param tilesY Number of tile rows of page
+ * @param page Index of shown page
+ *****************************************************************************/
+typedef struct {
+  Simulation_t simulation;
+  Snapshot_t snapshots[SIM_GAMES_MAX];
+  bool isShown[SIM_GAMES_MAX];
+  int tilesX;
+  int tilesY;
+  int page;
+} Viewer_t;
+
+/*****************************************************************************
+ * @brief Viewer loop
+ *
+ * Run simulation of games on all CPUs and show them in a tiled grid at
+ *VIEWER_RATE at most. Left and right arrows switch pages, Q exits
+ *
+ * @param gamesCount Number of games: [1..SIM_GAMES_MAX]
+ * @param isBot Flag to drive games by bots instead of random driver
+ *****************************************************************************/
+void viewerLoop(int gamesCount, bool isBot);
+
+/*****************************************************************************
+ * @brief Viewer initialization
+ *
+ * Initialize ncurses settings and color pairs of half-block pixels
+ *****************************************************************************/
+void initViewer(void);
+
+/*****************************************************************************
+ * @brief Layout tiles
+ *
+ * Fit tiles to terminal size and mark every tile to be redrawn
+ *
+ * @param viewer Pointer to struct of Viewer_t
+ *****************************************************************************/
+void layoutViewer(Viewer_t *viewer);
+
+/*****************************************************************************
+ * @brief Draw viewer
+ *
+ * Read snapshots of games on shown page and redraw only tiles whose snapshot
+ *has changed
+ *
+ * @param viewer Pointer to struct of Viewer_t
+ *****************************************************************************/
+void drawViewer(Viewer_t *viewer);
+
+/*****************************************************************************
+ * @brief Draw tile
+ *
+ * Draw label and field of one game
+ *
+ * @param index Index of game
+ * @param row Screen row of tile
+ * @param col Screen col of tile
+ * @param snapshot Snapshot of game
+ *****************************************************************************/
+void drawTile(int index, int row, int col, const Snapshot_t *snapshot);
+
+/*****************************************************************************
+ * @brief Get color pair of two pixels
+ *
+ * Color pair for terminal cell with upper pixel drawn by foreground of "▀"
+ *and lower pixel by background. Pixels of the same color need no pair of
+ *their own and share a pair with the same background
+ *
+ * @param upper Upper pixel: 0 for empty pixel or figure type + 1
+ * @param lower Lower pixel: 0 for empty pixel or figure type + 1
+ * @return int Color pair number
+ *****************************************************************************/
+int getTilePair(int upper, int lower);
+
+/*****************************************************************************
+ * @brief Get color of pixel
+ *
+ * @param pixel 0 for empty pixel or figure type + 1
+ * @return short Terminal color
+ *****************************************************************************/
+short getPixelColor(int pixel);
+
+/*****************************************************************************
+ * @brief Viewer destruction
+ *
+ * Restore terminal
+ *****************************************************************************/
+void destroyViewer(void);
+
+#endif  // VIEWER_H
@@ -0,0 +1,118 @@
+#include <check.h>
+#include <stdlib.h>
+
+#include "../brick_game/tetris/tetris_bot.h"
+#include "../brick_game/tetris/tetris_logic.h"
+
+#define STEPS 200000
+#define STEP_TICKS 10
+
+// Heap calls of the whole process, counted only while isCounting is set
+static bool isCounting = false;
+static unsigned long allocations = 0;
+static unsigned long frees = 0;
+
+#ifdef __GLIBC__
+// Interpose allocator of the process, stdio inside libc is counted too
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+  if (isCounting) ++allocations;
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  if (isCounting) ++allocations;
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+  if (isCounting) ++allocations;
+  return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) {
+  if (isCounting && pointer) ++frees;
+  __libc_free(pointer);
+}
+#endif
+
+// startGame, updateTicks, processAction, attachFigure and game over
+START_TEST(tc_alloc_1) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  Bot_t bot;
+  params.data = &data;
+  params.figure = &figure;
+
+  // High score file is read here, bot tables are filled by the first plan
+  initializeParameters(&params);
+  seedParameters(&params, 3);
+  initializeBot(&bot, NULL, 0);
+  processAction(&params, Start);
+  getBotAction(&bot, &params);
+
+  unsigned int seed = 5;
+  unsigned long attaches = 0;
+  unsigned long gameOvers = 0;
+  int lines = 0;
+
+  // Nothing is asserted while counting: check itself may allocate
+  isCounting = true;
+  for (int step = 0; step < STEPS; ++step) {
+    unsigned long spawnCount = params.spawnCount;
+    int score = data.score;
+
+    // Bot clears lines, random moves top the field out
+    UserAction_t action = (UserAction_t)(Left + getRandom(&seed) % 5);
+    if (gameOvers % 2) action = getBotAction(&bot, &params);
+    processAction(&params, action);
+    updateTicks(&params, params.ticks + STEP_TICKS);
+
+    attaches += params.spawnCount - spawnCount;
+    lines += data.score > score;
+    if (params.state == GAME_OVER) {
+      ++gameOvers;
+      processAction(&params, Start);
+    }
+  }
+  isCounting = false;
+
+  ck_assert_uint_gt(attaches, 1000);
+  ck_assert_uint_gt(gameOvers, 2);
+  ck_assert_int_gt(lines, 10);
+#ifdef __GLIBC__
+  ck_assert_uint_eq(allocations, 0);
+  ck_assert_uint_eq(frees, 0);
+#endif
+
+  processAction(&params, Terminate);
+}
+END_TEST
+
+Suite *tetris_alloc_suite() {
+  TCase *tc = tcase_create("[alloc] cases");
+  tcase_set_timeout(tc, 60);
+  tcase_add_test(tc, tc_alloc_1);
+
+  Suite *s = suite_create("[s21_tetris] alloc suite");
+  suite_add_tcase(s, tc);
+
+  return s;
+}
+
+int main(void) {
+  Suite *ts = tetris_alloc_suite();
+  SRunner *sr = srunner_create(ts);
+
+  srunner_run_all(sr, CK_NORMAL);
+
+  int number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+
+  return (0 == number_failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,8 +1,29 @@
 #include <check.h>
+#include <limits.h>
 #include <locale.h>
+#include <ncurses.h>
+#include <signal.h>
 #include <stdlib.h>
-
+#include <time.h>
+#include <unistd.h>
+
+#include "../brick_game/tetris/tetris_analytics.h"
+#include "../brick_game/tetris/tetris_beam.h"
+#include "../brick_game/tetris/tetris_board.h"
+#include "../brick_game/tetris/tetris_core.h"
+#include "../brick_game/tetris/tetris_counters.h"
+#include "../brick_game/tetris/tetris_bot.h"
+#include "../brick_game/tetris/tetris_eval.h"
+#include "../brick_game/tetris/tetris_expect.h"
+#include "../brick_game/tetris/tetris_hash.h"
 #include "../brick_game/tetris/tetris_logic.h"
+#include "../brick_game/tetris/tetris_pc.h"
+#include "../brick_game/tetris/tetris_rollout.h"
+#include "../brick_game/tetris/tetris_sim.h"
+#include "../brick_game/tetris/tetris_stats.h"
+#include "../brick_game/tetris/tetris_trace.h"
+#include "../brick_game/tetris/tetris_vec.h"
+#include "../gui/cli/tetris_input.h"
 
 #define AMOUNT 1
 #define FALSE 0
@@ -158,7 +179,8 @@ START_TEST(tc_logic_8) {
   params.figure = &figure;
 
   initializeParameters(&params);
-  params.figure->typeNext = generateRandomFigure(params.data->next);
+  params.figure->typeNext =
+      generateRandomFigure(params.data->next, &params.seed);
 
   ck_assert_int_ge(params.figure->typeNext, 0);
   ck_assert_int_le(params.figure->typeNext, 6);
@@ -771,6 +793,1350 @@ START_TEST(tc_logic_36) {
 }
 END_TEST
 
+// updateTicks
+START_TEST(tc_logic_37) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+
+  initializeParameters(&params);
+  updateTicks(&params, 100);
+  processAction(&params, Start);
+  int startY = params.figure->y;
+  updateTicks(&params, 100 + getGravityDelay(SPEED_MIN) - 1);
+
+  ck_assert_int_eq(params.figure->y, startY);
+
+  updateTicks(&params, 100 + getGravityDelay(SPEED_MIN));
+
+  ck_assert_int_eq(params.figure->y, startY + 1);
+  ck_assert_uint_eq(params.ticks, 100 + getGravityDelay(SPEED_MIN));
+  removeParameters(&params);
+}
+END_TEST
+
+START_TEST(tc_logic_38) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+
+  initializeParameters(&params);
+  processAction(&params, Start);
+  processAction(&params, Pause);
+  int startY = params.figure->y;
+  updateTicks(&params, getGravityDelay(SPEED_MIN) * 3);
+  processAction(&params, Pause);
+  updateTicks(&params, getGravityDelay(SPEED_MIN) * 4 - 1);
+
+  ck_assert_int_eq(params.figure->y, startY);
+  ck_assert_uint_eq(params.gravityTick, getGravityDelay(SPEED_MIN) * 3);
+
+  updateTicks(&params, 1);
+
+  ck_assert_uint_eq(params.ticks, getGravityDelay(SPEED_MIN) * 4 - 1);
+  removeParameters(&params);
+}
+END_TEST
+
+// getGravityDelay
+START_TEST(tc_logic_39) {
+  ck_assert_uint_eq(getGravityDelay(SPEED_MIN), 1440);
+  ck_assert_uint_eq(getGravityDelay(9), 160);
+  ck_assert_uint_eq(getGravityDelay(SPEED_MAX), GRAVITY_DELAY_MIN);
+}
+END_TEST
+
+// seedParameters
+START_TEST(tc_logic_40) {
+  GameParameters_t params[2];
+  GameInfo_t data[2];
+  Figure_t figure[2];
+  UserAction_t actions[] = {Start, Left, Action, Right, Right, Down};
+
+  for (int game = 0; game < 2; ++game) {
+    params[game].data = &data[game];
+    params[game].figure = &figure[game];
+    initializeParameters(&params[game]);
+    seedParameters(&params[game], 42);
+
+    for (unsigned long tick = 0; tick < 20000; tick += 700) {
+      updateTicks(&params[game], tick);
+      processAction(&params[game], actions[tick / 700 % 6]);
+    }
+  }
+
+  bool isFieldEqual = true;
+  for (int row = 0; row < FIELD_HEIGHT; ++row)
+    for (int col = 0; col < FIELD_WIDTH; ++col)
+      isFieldEqual = isFieldEqual &&
+                     data[0].field[row][col] == data[1].field[row][col];
+
+  ck_assert_int_eq(isFieldEqual, true);
+  ck_assert_int_eq(figure[0].type, figure[1].type);
+  ck_assert_int_eq(figure[0].typeNext, figure[1].typeNext);
+  ck_assert_int_eq(data[0].score, data[1].score);
+  removeParameters(&params[0]);
+  removeParameters(&params[1]);
+}
+END_TEST
+
+// getRandom
+START_TEST(tc_logic_41) {
+  unsigned int seed = 1;
+  unsigned int first = getRandom(&seed);
+
+  ck_assert_uint_eq(first, 270369);
+  ck_assert_uint_eq(seed, first);
+  ck_assert_uint_ne(getRandom(&seed), first);
+}
+END_TEST
+
+// readSnapshot
+START_TEST(tc_logic_42) {
+  static Simulation_t sim;
+  Snapshot_t snapshot;
+
+  initializeSimulation(&sim, 2, 7);
+  SimGame_t *game = &sim.games[0];
+
+  ck_assert_int_eq(game->parameters.state, GAME);
+  ck_assert_ptr_null(game->parameters.dataPath);
+  ck_assert_int_eq(readSnapshot(game, &snapshot), true);
+  ck_assert_int_eq(readSnapshot(game, &snapshot), false);
+
+  stepSimGame(game);
+  ck_assert_uint_eq(game->parameters.ticks, SIM_STEP_TICKS);
+  ck_assert_int_eq(readSnapshot(game, &snapshot), true);
+
+  bool isFieldEqual = true;
+  for (int row = 0; row < SNAPSHOT_ROWS; ++row)
+    for (int col = 0; col < SNAPSHOT_COLS; ++col)
+      isFieldEqual =
+          isFieldEqual && snapshot.field[row][col] ==
+                              game->data.field[row + BORDER_SIZE]
+                                              [col + BORDER_SIZE];
+
+  ck_assert_int_eq(isFieldEqual, true);
+  ck_assert_int_eq(snapshot.score, game->data.score);
+  removeSimulation(&sim);
+}
+END_TEST
+
+// startSimulation
+START_TEST(tc_logic_43) {
+  static Simulation_t sim;
+
+  initializeSimulation(&sim, SIM_GAMES_MAX + 1, 1);
+  ck_assert_int_eq(sim.gamesCount, SIM_GAMES_MAX);
+
+  // Games are read only after threads are joined
+  sim.spawnLimit = 20;
+  startSimulation(&sim, 2);
+  ck_assert_int_eq(sim.threadsCount, 2);
+  waitSimulation(&sim);
+
+  for (int i = 0; i < sim.gamesCount; ++i) {
+    ck_assert_uint_gt(sim.games[i].parameters.ticks, 0);
+    ck_assert_uint_ge(sim.games[i].parameters.spawnCount, sim.spawnLimit);
+  }
+  ck_assert_int_ne(sim.games[0].parameters.seed,
+                   sim.games[1].parameters.seed);
+  removeSimulation(&sim);
+}
+END_TEST
+
+// generatePlacements
+START_TEST(tc_logic_44) {
+  Board_t board;
+  Placement_t placements[PLACEMENTS_MAX];
+  int counts[FIGURES_COUNT] = {17, 34, 34, 9, 17, 34, 17};
+
+  resetBoard(&board);
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Figure_t figure = {0, type, 0, FIELD_WIDTH / 2, 3};
+
+    ck_assert_int_eq(generatePlacements(&board, &figure, placements),
+                     counts[type]);
+  }
+}
+END_TEST
+
+// initializeBoard
+START_TEST(tc_logic_45) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  Board_t board, empty;
+
+  initializeParameters(&params);
+  startGame(&params);
+  initializeBoard(&board, data.field, &figure);
+  resetBoard(&empty);
+
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    ck_assert_uint_eq(board.rows[row], empty.rows[row]);
+  }
+
+  initializeBoard(&board, data.field, NULL);
+  ck_assert_int_eq(isPieceCollide(&board, getPiece(figure.type, 0), figure.x,
+                                  figure.y),
+                   true);
+  removeParameters(&params);
+}
+END_TEST
+
+// generatePlacements
+START_TEST(tc_logic_46) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  Board_t board;
+  Placement_t placements[PLACEMENTS_MAX];
+
+  initializeParameters(&params);
+  for (int col = 5; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
+    data.field[FIELD_HEIGHT - BORDER_SIZE - 3][col] = 1;
+  }
+  initializeBoard(&board, data.field, NULL);
+
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Figure_t start = {0, type, 0, FIELD_WIDTH / 2, 3};
+    int count = generatePlacements(&board, &start, placements);
+    bool isTucked = false;
+
+    for (int i = 0; i < count; ++i) {
+      figure.type = type;
+      figure.x = placements[i].x;
+      figure.y = placements[i].y;
+      figure.rotation = placements[i].rotation;
+      ck_assert_int_eq(isFigureNotCollide(&params), true);
+      figure.y++;
+      ck_assert_int_eq(isFigureNotCollide(&params), false);
+
+      const Piece_t *piece = getPiece(type, figure.rotation);
+      isTucked = isTucked || (figure.y - 1 + piece->top + piece->height - 1 ==
+                                  FIELD_HEIGHT - BORDER_SIZE - 1 &&
+                              figure.x + piece->left >= 5);
+    }
+
+    // Hero is too wide to pass through the gap under the roof
+    ck_assert_int_eq(isTucked, type != 0);
+  }
+  removeParameters(&params);
+}
+END_TEST
+
+// removeBoardRows
+START_TEST(tc_logic_47) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  Board_t board, removed;
+
+  initializeParameters(&params);
+  for (int row = 12; row < FIELD_HEIGHT - BORDER_SIZE; ++row) {
+    for (int col = BORDER_SIZE; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
+      data.field[row][col] = row % 3 == 0 || col != row % 10 + BORDER_SIZE;
+    }
+  }
+
+  initializeBoard(&board, data.field, NULL);
+  int rows = removeFullRows(&params);
+  initializeBoard(&removed, data.field, NULL);
+
+  ck_assert_int_eq(rows, 4);
+  ck_assert_int_eq(removeBoardRows(&board), rows);
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    ck_assert_uint_eq(board.rows[row], removed.rows[row]);
+  }
+  removeParameters(&params);
+}
+END_TEST
+
+// getFeatures
+START_TEST(tc_logic_48) {
+  Board_t board;
+  Features_t features;
+  int values[FEATURES_COUNT] = {12, 1, 6, 48, 12, 1, 2};
+
+  resetBoard(&board);
+  board.rows[22] |= 0x1FF << BORDER_SIZE;
+  board.rows[21] |= 1 << BORDER_SIZE;
+  board.rows[20] |= 1 << (BORDER_SIZE + 5);
+  getFeatures(&board, 2, &features);
+
+  for (int feature = 0; feature < FEATURES_COUNT; ++feature) {
+    ck_assert_int_eq(features.values[feature], values[feature]);
+  }
+}
+END_TEST
+
+// evaluateBoards
+START_TEST(tc_logic_49) {
+  Board_t boards[37];
+  int lines[37];
+  float expected[37], scores[37];
+  unsigned int seed = 5;
+
+  for (int i = 0; i < 37; ++i) {
+    resetBoard(&boards[i]);
+    for (int row = 8 + i % 10; row < FIELD_HEIGHT - BORDER_SIZE; ++row) {
+      boards[i].rows[row] |= (uint16_t)(getRandom(&seed) & ROW_FULL);
+    }
+    lines[i] = i % 5;
+  }
+
+  evaluateBoardsScalar(boards, lines, 37, &defaultWeights, expected);
+  evaluateBoards(boards, lines, 37, &defaultWeights, scores);
+  for (int i = 0; i < 37; ++i) {
+    ck_assert_float_eq(scores[i], expected[i]);
+  }
+
+#if defined(__x86_64__)
+  evaluateBoardsSse2(boards, lines, 37, &defaultWeights, scores);
+  for (int i = 0; i < 37; ++i) {
+    ck_assert_float_eq(scores[i], expected[i]);
+  }
+#endif
+}
+END_TEST
+
+// findPath
+START_TEST(tc_logic_50) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  Board_t board;
+  Placement_t placements[PLACEMENTS_MAX];
+  UserAction_t actions[BOT_ACTIONS_MAX];
+  Placement_t states[BOT_ACTIONS_MAX];
+
+  initializeParameters(&params);
+  for (int col = 5; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
+    data.field[FIELD_HEIGHT - BORDER_SIZE - 3][col] = 1;
+  }
+  initializeBoard(&board, data.field, NULL);
+  params.state = GAME;
+
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Figure_t start = {0, type, 0, FIELD_WIDTH / 2, 3};
+    int count = generatePlacements(&board, &start, placements);
+
+    for (int i = 0; i < count; ++i) {
+      int length = findPath(&board, &start, &placements[i], actions, states);
+      ck_assert_int_gt(length, 0);
+      ck_assert_int_eq(actions[length - 1], Down);
+
+      // Every action but hard drop moves figure of game as planned
+      figure = start;
+      addFigure(&params);
+      for (int k = 0; k < length - 1; ++k) {
+        if (actions[k] == Up) {
+          shiftFigure(&params);
+        } else {
+          processAction(&params, actions[k]);
+        }
+        ck_assert_int_eq(figure.x, states[k].x);
+        ck_assert_int_eq(figure.y, states[k].y);
+        ck_assert_int_eq(figure.rotation, states[k].rotation);
+      }
+      clearFigure(&params);
+
+      const Piece_t *piece = getPiece(type, states[length - 1].rotation);
+      const Piece_t *target = getPiece(type, placements[i].rotation);
+      ck_assert_int_eq(piece->shape, target->shape);
+      ck_assert_int_eq(states[length - 1].x + piece->left,
+                       placements[i].x + target->left);
+      ck_assert_int_eq(states[length - 1].y + piece->top,
+                       placements[i].y + target->top);
+    }
+  }
+  removeParameters(&params);
+}
+END_TEST
+
+// getBotAction
+START_TEST(tc_logic_51) {
+  static Simulation_t sim;
+  SimGame_t *game = &sim.games[0];
+
+  initializeSimulation(&sim, 1, 5);
+  initializeSimulationBots(&sim, BOT_BUDGET);
+  game->parameters.state = GAME_OVER;
+  ck_assert_int_eq(getBotAction(&game->bot, &game->parameters), Start);
+  game->parameters.state = GAME;
+
+  while (game->parameters.spawnCount < 300) {
+    stepSimGame(game);
+  }
+
+  ck_assert_uint_eq(game->games, 0);
+  ck_assert_int_gt(game->data.score, 0);
+  removeSimulation(&sim);
+}
+END_TEST
+
+// setQueueLength
+START_TEST(tc_logic_52) {
+  GameParameters_t params[2];
+  GameInfo_t data[2];
+  Figure_t figure[2];
+
+  for (int i = 0; i < 2; ++i) {
+    params[i].data = &data[i];
+    params[i].figure = &figure[i];
+    initializeParameters(&params[i]);
+    params[i].dataPath = NULL;
+  }
+  setQueueLength(&params[1], QUEUE_MAX);
+  seedParameters(&params[0], 42);
+  seedParameters(&params[1], 42);
+  processAction(&params[0], Start);
+  processAction(&params[1], Start);
+  ck_assert_int_eq(params[1].queueLength, QUEUE_MAX);
+
+  // Longer queue shows the same figures earlier
+  int sequence[2][40];
+  int queued[40][QUEUE_MAX];
+  for (int k = 0; k < 40; ++k) {
+    for (int i = 0; i < QUEUE_MAX; ++i) {
+      queued[k][i] = getQueuedFigure(&params[1], i);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+      sequence[i][k] = figure[i].typeNext;
+      spawnNextFigure(&params[i]);
+      ck_assert_int_eq(figure[i].type, sequence[i][k]);
+    }
+  }
+
+  for (int k = 0; k < 40; ++k) {
+    ck_assert_int_eq(sequence[0][k], sequence[1][k]);
+    for (int i = 0; i < QUEUE_MAX && k + i < 40; ++i) {
+      ck_assert_int_eq(queued[k][i], sequence[1][k + i]);
+    }
+  }
+  ck_assert_int_eq(data[1].next[1][1], figure[1].typeNext + 1);
+
+  removeParameters(&params[0]);
+  removeParameters(&params[1]);
+}
+END_TEST
+
+// searchBeam
+START_TEST(tc_logic_53) {
+  static Beam_t beams[2];
+  Board_t board;
+  Figure_t figure;
+  Placement_t placements[2];
+  int types[QUEUE_MAX] = {1, 2, 3, 4, 5, 6};
+  int depths[2];
+
+  resetBoard(&board);
+  board.rows[22] |= 0x1F7 << BORDER_SIZE;
+  board.rows[21] |= 0x0F3 << BORDER_SIZE;
+  spawnBoardFigure(&board, 0, &figure);
+
+  initializeBeam(&beams[0], 8, 1);
+  initializeBeam(&beams[1], 8, 3);
+  for (int i = 0; i < 2; ++i) {
+    depths[i] = searchBeam(&beams[i], &board, &figure, types, QUEUE_MAX,
+                           &defaultWeights, LLONG_MAX, &placements[i]);
+  }
+
+  // Selection doesn't depend on number of workers
+  ck_assert_int_eq(depths[0], QUEUE_MAX + 1);
+  ck_assert_int_eq(depths[1], QUEUE_MAX + 1);
+  ck_assert_int_eq(placements[0].x, placements[1].x);
+  ck_assert_int_eq(placements[0].y, placements[1].y);
+  ck_assert_int_eq(placements[0].rotation, placements[1].rotation);
+
+  // Passed deadline still gives a placement of current figure
+  ck_assert_int_eq(searchBeam(&beams[1], &board, &figure, types, QUEUE_MAX,
+                              &defaultWeights, 0, &placements[1]),
+                   1);
+  removeBeam(&beams[0]);
+  removeBeam(&beams[1]);
+}
+END_TEST
+
+// getFieldHash
+START_TEST(tc_logic_54) {
+  static Simulation_t sim;
+  SimGame_t *game = &sim.games[0];
+  Board_t board;
+
+  initializeSimulation(&sim, 1, 9);
+  initializeSimulationBots(&sim, BOT_BUDGET);
+
+  // Hash of game leaves falling figure out and adds its type
+  while (game->parameters.spawnCount < 200) {
+    stepSimGame(game);
+    const Figure_t *figure = &game->figure;
+    ck_assert_uint_eq(
+        getGameHash(&game->parameters),
+        getFieldHash(game->data.field) ^
+            getPieceHash(getPiece(figure->type, figure->rotation), figure->x,
+                         figure->y) ^
+            getTypeKey(figure->type));
+  }
+  ck_assert_int_gt(game->data.score, 0);
+
+  initializeBoard(&board, game->data.field, NULL);
+  ck_assert_uint_eq(getBoardHash(&board), getFieldHash(game->data.field));
+  removeSimulation(&sim);
+}
+END_TEST
+
+// probeHash
+START_TEST(tc_logic_55) {
+  static Beam_t beams[2];
+  HashTable_t table;
+  Board_t board;
+  Figure_t figure;
+  Placement_t placements[3];
+  int types[QUEUE_MAX] = {6, 5, 4, 3, 2, 1};
+  uint64_t data = 0;
+
+  initializeHashTable(&table, 8);
+  ck_assert(!probeHash(&table, 0, &data));
+  storeHash(&table, 0, 77);
+  storeHash(&table, 1, 78);
+  ck_assert(probeHash(&table, 0, &data));
+  ck_assert_uint_eq(data, 77);
+  storeHash(&table, 256, 79);
+  ck_assert(!probeHash(&table, 0, &data));
+
+  resetBoard(&board);
+  board.rows[22] |= 0x3DF << BORDER_SIZE;
+  spawnBoardFigure(&board, 0, &figure);
+
+  // Cached evaluations give the same selection
+  initializeBeam(&beams[0], 16, 1);
+  initializeBeam(&beams[1], 16, 2);
+  beams[1].table = &table;
+  for (int i = 0; i < 3; ++i) {
+    ck_assert_int_eq(searchBeam(&beams[i > 0], &board, &figure, types,
+                                QUEUE_MAX, &defaultWeights, LLONG_MAX,
+                                &placements[i]),
+                     QUEUE_MAX + 1);
+    ck_assert_int_eq(placements[i].x, placements[0].x);
+    ck_assert_int_eq(placements[i].y, placements[0].y);
+    ck_assert_int_eq(placements[i].rotation, placements[0].rotation);
+  }
+
+  // Kept boards are distinct
+  for (int i = 0; i < beams[1].count; ++i) {
+    for (int j = 0; j < i; ++j) {
+      ck_assert_uint_ne(beams[1].nodes[i].hash, beams[1].nodes[j].hash);
+    }
+  }
+
+  removeBeam(&beams[0]);
+  removeBeam(&beams[1]);
+  removeHashTable(&table);
+}
+END_TEST
+
+// searchRollout
+START_TEST(tc_logic_56) {
+  static Rollout_t rollout;
+  Board_t board;
+  Figure_t figure;
+  Placement_t placement;
+  uint64_t random[2] = {7, 7};
+
+  resetBoard(&board);
+  for (int row = 19; row < 23; ++row) {
+    board.rows[row] |= 0x3DF << BORDER_SIZE;
+  }
+  spawnBoardFigure(&board, 0, &figure);
+
+  // The same PRNG state plays the same rollout
+  ck_assert(playRollout(&board, 0, 16, &random[0]) ==
+            playRollout(&board, 0, 16, &random[1]));
+  ck_assert_uint_eq(random[0], random[1]);
+
+  // Only I figure in the well removes rows, O figures can't
+  initializeRollout(&rollout, 1, 3, 1);
+  ck_assert_uint_eq(searchRollout(&rollout, &board, &figure, 3, 0,
+                                  &placement),
+                    (unsigned long)rollout.count * 3);
+  placePiece(&board, getPiece(0, placement.rotation), placement.x,
+             placement.y);
+  ck_assert_uint_eq(board.rows[22] & ROW_FULL, 0);
+  ck_assert(getRolloutRate(&rollout) > 0);
+  removeRollout(&rollout);
+
+  // Rollout that can't spawn a figure loses
+  for (int row = 0; row < 23; ++row) board.rows[row] |= ROW_FULL;
+  ck_assert(playRollout(&board, 0, 4, &random[0]) == -ROLLOUT_PENALTY);
+}
+END_TEST
+
+// analyzeExpectimax
+START_TEST(tc_logic_57) {
+  static Expectimax_t expect;
+  static Placement_t placements[2][PLACEMENTS_MAX];
+  static float values[2][PLACEMENTS_MAX];
+  Board_t board;
+  Figure_t figure;
+  int types[1] = {5};
+
+  resetBoard(&board);
+  board.rows[22] |= 0x3DF << BORDER_SIZE;
+  board.rows[21] |= 0x1CF << BORDER_SIZE;
+  spawnBoardFigure(&board, 2, &figure);
+  initializeExpectimax(&expect, 3, NULL, 12);
+
+  // One ply is the evaluation of placement
+  expect.depth = 1;
+  int count = analyzeExpectimax(&expect, &board, &figure, types, 1, 0,
+                                placements[0], values[0]);
+  ck_assert_int_gt(count, 0);
+  ck_assert_int_eq(expect.completed, 1);
+  for (int i = 0; i < count; ++i) {
+    Board_t next = board;
+    int lines = placePiece(&next, getPiece(2, placements[0][i].rotation),
+                           placements[0][i].x, placements[0][i].y);
+    ck_assert(fabsf(values[0][i] -
+                    evaluateBoard(&next, lines, &defaultWeights)) < 1e-3f);
+  }
+
+  // Memoized values are the same as searched ones
+  expect.depth = 3;
+  for (int k = 0; k < 2; ++k) {
+    ck_assert_int_eq(analyzeExpectimax(&expect, &board, &figure, types, 1,
+                                       LLONG_MAX, placements[k], values[k]),
+                     count);
+    ck_assert_int_eq(expect.completed, 3);
+  }
+  for (int i = 0; i < count; ++i) {
+    ck_assert(values[0][i] == values[1][i]);
+    ck_assert(values[0][i] > EXPECT_LOSS);
+  }
+
+  // Passed deadline keeps the first ply
+  analyzeExpectimax(&expect, &board, &figure, types, 1, 0, placements[0],
+                    values[0]);
+  ck_assert_int_eq(expect.completed, 1);
+
+  for (int row = 0; row < 23; ++row) board.rows[row] |= ROW_FULL;
+  expect.searchDepth = 2;
+  expect.deadline = LLONG_MAX;
+  ck_assert(getChanceValue(&expect, &board, 0, 1) == EXPECT_LOSS);
+  removeExpectimax(&expect);
+}
+END_TEST
+
+// solvePerfectClear
+START_TEST(tc_logic_58) {
+  static PerfectClear_t pc;
+  Board_t board, empty;
+  Figure_t figure;
+  Placement_t placements[PC_PIECES_MAX];
+  int types[QUEUE_MAX] = {3, 3, 3, 3, 0, 0};
+  uint64_t region;
+
+  resetBoard(&empty);
+  initializePerfectClear(&pc, NULL, 12);
+  ck_assert(isPcFillable(0, 2));
+  ck_assert(!isPcFillable(~0x3ull, 1));
+
+  // Five O figures clear two rows
+  for (int k = 0; k < 2; ++k) {
+    board = empty;
+    spawnBoardFigure(&board, 3, &figure);
+    ck_assert_int_eq(solvePerfectClear(&pc, &board, &figure, types, 4,
+                                       LLONG_MAX, placements),
+                     5);
+    for (int i = 0; i < 5; ++i) {
+      placePiece(&board, getPiece(3, placements[i].rotation),
+                 placements[i].x, placements[i].y);
+    }
+    ck_assert_mem_eq(board.rows, empty.rows, sizeof(board.rows));
+  }
+
+  // I figures can't fill 2x2 hole, figures above region can't be cleared
+  board = empty;
+  board.rows[22] |= 0x3CF << BORDER_SIZE;
+  board.rows[21] |= 0x3CF << BORDER_SIZE;
+  spawnBoardFigure(&board, 0, &figure);
+  ck_assert_int_eq(solvePerfectClear(&pc, &board, &figure, types + 4, 2,
+                                     LLONG_MAX, placements),
+                   0);
+  spawnBoardFigure(&board, 3, &figure);
+  ck_assert_int_eq(solvePerfectClear(&pc, &board, &figure, types, 4,
+                                     LLONG_MAX, placements),
+                   1);
+  board.rows[10] |= 1 << BORDER_SIZE;
+  ck_assert(!getPcRegion(&board, &region));
+  ck_assert_int_eq(solvePerfectClear(&pc, &board, &figure, types, 4,
+                                     LLONG_MAX, placements),
+                   0);
+  removePerfectClear(&pc);
+
+  // Database keeps the same answers
+  ck_assert_uint_gt(buildPcDatabase("pc_test.db"), 0);
+  initializePerfectClear(&pc, "pc_test.db", 12);
+  ck_assert_ptr_nonnull(pc.db);
+  ck_assert(isPcSolvable(&pc, 0x3CF | 0x3CFull << PC_COLS, 2));
+  ck_assert(isPcSolvable(&pc, 0x3F0, 1));
+  ck_assert(!isPcSolvable(&pc, 0x3E4, 1));
+  board = empty;
+  spawnBoardFigure(&board, 3, &figure);
+  ck_assert_int_eq(solvePerfectClear(&pc, &board, &figure, types, 4,
+                                     LLONG_MAX, placements),
+                   5);
+  removePerfectClear(&pc);
+  remove("pc_test.db");
+}
+END_TEST
+
+// findCachedPath and searchPath
+START_TEST(tc_logic_59) {
+  Board_t board;
+  Placement_t placements[PLACEMENTS_MAX];
+  UserAction_t actions[BOT_ACTIONS_MAX];
+  Placement_t states[BOT_ACTIONS_MAX];
+  UserAction_t searched[BOT_ACTIONS_MAX];
+  Placement_t searchedStates[BOT_ACTIONS_MAX];
+
+  // Empty board: every path is cached, has no waits and the fewest inputs
+  resetBoard(&board);
+  for (int type = 0; type < FIGURES_COUNT; ++type) {
+    Figure_t figure;
+    spawnBoardFigure(&board, type, &figure);
+    int count = generatePlacements(&board, &figure, placements);
+
+    for (int i = 0; i < count; ++i) {
+      int length =
+          findCachedPath(&board, &figure, &placements[i], actions, states);
+      int searchedLength = searchPath(&board, &figure, &placements[i],
+                                      searched, searchedStates);
+      int rotations = 0;
+
+      ck_assert_int_gt(length, 0);
+      ck_assert_int_eq(length, searchedLength);
+      ck_assert_mem_eq(actions, searched, sizeof(actions[0]) * length);
+      ck_assert_mem_eq(states, searchedStates, sizeof(states[0]) * length);
+      for (int k = 0; k < length - 1; ++k) {
+        ck_assert_int_ne(actions[k], Up);
+        rotations += actions[k] == Action;
+      }
+      ck_assert_int_lt(rotations, ROTATIONS_COUNT);
+    }
+  }
+
+  // Figure at spawn needs only hard drop
+  Figure_t figure;
+  spawnBoardFigure(&board, 5, &figure);
+  Placement_t drop = {(unsigned char)figure.x, 0, 0};
+  const Piece_t *piece = getPiece(5, 0);
+  for (int y = figure.y; !isPieceCollide(&board, piece, figure.x, y); ++y) {
+    drop.y = (unsigned char)y;
+  }
+  ck_assert_int_eq(findPath(&board, &figure, &drop, actions, states), 1);
+  ck_assert_int_eq(actions[0], Down);
+
+  // Pixel near the top disables cache
+  board.rows[figure.y + 1] |= 1u << BORDER_SIZE;
+  ck_assert_int_eq(
+      findCachedPath(&board, &figure, &drop, actions, states), 0);
+  ck_assert_int_eq(findPath(&board, &figure, &drop, actions, states), 1);
+
+  // Tucked placement under overhang is searched with waits
+  resetBoard(&board);
+  for (int col = BORDER_SIZE + 2; col < FIELD_WIDTH - BORDER_SIZE; ++col) {
+    board.rows[FIELD_HEIGHT - BORDER_SIZE - 3] |= (uint16_t)(1u << col);
+  }
+  spawnBoardFigure(&board, 3, &figure);
+  int count = generatePlacements(&board, &figure, placements);
+  int tucks = 0;
+
+  for (int i = 0; i < count; ++i) {
+    int length = findPath(&board, &figure, &placements[i], actions, states);
+    bool isTuck = false;
+
+    ck_assert_int_gt(length, 0);
+    for (int k = 0; k < length - 1; ++k) isTuck |= actions[k] == Up;
+    if (isTuck) {
+      ck_assert_int_eq(
+          findCachedPath(&board, &figure, &placements[i], actions, states),
+          0);
+      ++tucks;
+    }
+  }
+  ck_assert_int_gt(tucks, 0);
+}
+END_TEST
+
+// stepVecEnv
+START_TEST(tc_logic_60) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  VecEnv_t env;
+  unsigned char actions[2];
+  unsigned char observations[2 * VEC_OBSERVATION_SIZE];
+  float rewards[2];
+  unsigned char dones[2];
+  unsigned int seed = 3;
+  unsigned long games = 0;
+
+  initializeParameters(&params);
+  params.dataPath = NULL;
+  seedParameters(&params, 7);
+  processAction(&params, Start);
+  initializeVecEnv(&env, 2, 7, 1);
+
+  // Game 0 follows game logic with gravity shift after every action
+  for (int step = 0; step < 20000; ++step) {
+    UserAction_t options[6] = {Left, Right, Action, Down, Up, Down};
+    actions[0] = (unsigned char)options[getRandom(&seed) % 6];
+    actions[1] = Down;
+    int score = data.score;
+
+    processAction(&params, actions[0]);
+    if (actions[0] != Down) shiftFigure(&params);
+    stepVecEnv(&env, actions, observations, rewards, dones);
+
+    ck_assert_int_eq(dones[0], params.state == GAME_OVER);
+    if (params.state == GAME_OVER) {
+      processAction(&params, Start);
+      ++games;
+    } else {
+      ck_assert_float_eq(rewards[0], (float)(data.score - score));
+    }
+
+    Board_t board;
+    initializeBoard(&board, data.field, &figure);
+    ck_assert_mem_eq(board.rows, env.boards[0].rows, sizeof(board.rows));
+    ck_assert_int_eq(data.score, env.scores[0]);
+    ck_assert_int_eq(figure.type, env.types[0]);
+    ck_assert_int_eq(figure.typeNext, env.typesNext[0]);
+    ck_assert_int_eq(figure.x, env.xs[0]);
+    ck_assert_int_eq(figure.y, env.ys[0]);
+    ck_assert_int_eq(figure.rotation, env.rotations[0]);
+
+    for (int i = 0; i < VEC_OBSERVATION_SIZE; ++i) {
+      int row = i / VEC_COLS + BORDER_SIZE;
+      int col = i % VEC_COLS + BORDER_SIZE;
+      ck_assert_int_eq(observations[i] == VEC_PIXEL_FILLED,
+                       board.rows[row] >> col & 1);
+    }
+  }
+
+  ck_assert_uint_gt(games, 0);
+  ck_assert_uint_eq(games, env.games[0]);
+  ck_assert_uint_gt(env.games[1], 0);
+
+  removeVecEnv(&env);
+  removeParameters(&params);
+}
+END_TEST
+
+// enableVecPlanes and setVecQueueLength
+START_TEST(tc_logic_61) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  VecEnv_t env;
+  unsigned char actions[3];
+  unsigned char observations[3 * VEC_OBSERVATION_SIZE];
+  unsigned char planes[VEC_PLANES_SIZE];
+  unsigned char nextPlanes[VEC_NEXT_SIZE];
+  unsigned int seed = 5;
+
+  initializeParameters(&params);
+  params.dataPath = NULL;
+  seedParameters(&params, 11);
+  processAction(&params, Start);
+  setQueueLength(&params, 3);
+  initializeVecEnv(&env, 3, 11, 1);
+  setVecQueueLength(&env, 3);
+  enableVecPlanes(&env);
+  unsigned char *address = env.planes;
+
+  for (int step = 0; step < 5000; ++step) {
+    UserAction_t options[6] = {Left, Right, Action, Up, Down, Up};
+    for (int i = 0; i < 3; ++i) {
+      actions[i] = (unsigned char)options[getRandom(&seed) % 6];
+    }
+
+    processAction(&params, actions[0]);
+    if (actions[0] != Down) shiftFigure(&params);
+    if (params.state == GAME_OVER) processAction(&params, Start);
+    stepVecEnv(&env, actions, observations, NULL, NULL);
+
+    // Queue follows game logic
+    ck_assert_int_eq(getQueuedFigure(&params, 0), env.typesNext[0]);
+    for (int k = 1; k < 3; ++k) {
+      ck_assert_int_eq(getQueuedFigure(&params, k), env.queues[k - 1]);
+    }
+
+    // Updated planes are equal to planes written from scratch
+    for (int i = 0; i < 3; ++i) {
+      writeVecPlanes(&env, i, planes, nextPlanes);
+      ck_assert_mem_eq(env.planes + i * VEC_PLANES_SIZE, planes,
+                       VEC_PLANES_SIZE);
+      ck_assert_mem_eq(env.nextPlanes + i * VEC_NEXT_SIZE, nextPlanes,
+                       VEC_NEXT_SIZE);
+
+      const unsigned char *observation = observations +
+                                         i * VEC_OBSERVATION_SIZE;
+      for (int k = 0; k < VEC_OBSERVATION_SIZE; ++k) {
+        ck_assert_int_eq(planes[VEC_PLANE_OCCUPANCY * VEC_OBSERVATION_SIZE +
+                                k],
+                         observation[k] == VEC_PIXEL_FILLED);
+        ck_assert_int_eq(planes[VEC_PLANE_FIGURE * VEC_OBSERVATION_SIZE + k],
+                         observation[k] == VEC_PIXEL_FIGURE);
+      }
+
+      int ones = 0;
+      for (int k = 0; k < VEC_NEXT_SIZE; ++k) ones += nextPlanes[k];
+      ck_assert_int_eq(ones, 3);
+      ck_assert_int_eq(nextPlanes[env.typesNext[i]], 1);
+    }
+  }
+
+  ck_assert_ptr_eq(env.planes, address);
+  ck_assert_uint_gt(env.games[0], 0);
+
+  removeVecEnv(&env);
+  removeParameters(&params);
+}
+END_TEST
+
+// createTetrisGame and createTetrisVec
+START_TEST(tc_logic_62) {
+  ck_assert_uint_eq(getTetrisCoreVersion() >> 16, TETRIS_CORE_VERSION_MAJOR);
+
+  // Game of handle is the engine game of the same seed
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  initializeParametersPath(&params, NULL);
+  seedParameters(&params, 7);
+  setQueueLength(&params, 3);
+  processAction(&params, Start);
+
+  TetrisGame_t *game = createTetrisGame(7, 3);
+  uint8_t field[TETRIS_ROWS * TETRIS_COLS];
+  unsigned int seed = 11;
+  bool isOver = false;
+
+  for (int step = 0; step < 3000 && !isOver; ++step) {
+    int action = Left + (int)(getRandom(&seed) % 5);
+    if (action == Up) action = Down;
+
+    processAction(&params, (UserAction_t)action);
+    updateTicks(&params, params.ticks + 100);
+    isOver = stepTetrisGame(game, action, 100);
+    ck_assert_int_eq(isOver, params.state == GAME_OVER);
+    ck_assert_int_eq(getTetrisScore(game), data.score);
+
+    readTetrisField(game, field);
+    for (int row = 0; row < TETRIS_ROWS; ++row) {
+      for (int col = 0; col < TETRIS_COLS; ++col) {
+        ck_assert_int_eq(field[row * TETRIS_COLS + col],
+                         data.field[row + BORDER_SIZE][col + BORDER_SIZE]);
+      }
+    }
+  }
+  ck_assert(isOver);
+
+  // Terminate is ignored, Start restarts
+  ck_assert(stepTetrisGame(game, Terminate, 0));
+  ck_assert(!stepTetrisGame(game, TETRIS_ACTION_START, 0));
+  ck_assert_int_eq(getTetrisScore(game), 0);
+  destroyTetrisGame(game);
+  destroyTetrisGame(NULL);
+  removeParameters(&params);
+
+  // Planes of handle are planes of environments, at the same address
+  VecEnv_t env;
+  initializeVecEnv(&env, 4, 5, 2);
+  setVecQueueLength(&env, 2);
+  enableVecPlanes(&env);
+
+  TetrisVec_t *vec = createTetrisVec(4, 5, 2, 2);
+  const uint8_t *planes = getTetrisVecPlanes(vec);
+  const uint8_t *nextPlanes = getTetrisVecNextPlanes(vec);
+  unsigned char actions[4];
+  float rewards[4];
+  unsigned char dones[4];
+
+  for (int step = 0; step < 500; ++step) {
+    for (int i = 0; i < 4; ++i) {
+      actions[i] = (unsigned char)(Left + getRandom(&seed) % 5);
+    }
+
+    stepVecEnv(&env, actions, NULL, NULL, NULL);
+    stepTetrisVec(vec, actions, rewards, dones);
+    ck_assert_ptr_eq(getTetrisVecPlanes(vec), planes);
+    ck_assert_mem_eq(planes, env.planes, 4 * VEC_PLANES_SIZE);
+    ck_assert_mem_eq(nextPlanes, env.nextPlanes, 4 * VEC_NEXT_SIZE);
+    for (int i = 0; i < 4; ++i) {
+      ck_assert_int_eq(getTetrisVecScore(vec, i), env.scores[i]);
+    }
+  }
+  ck_assert_int_eq(getTetrisVecScore(vec, 4), 0);
+
+  destroyTetrisVec(vec);
+  removeVecEnv(&env);
+}
+END_TEST
+
+// initializeCounters, startCounters and stopCounters
+START_TEST(tc_logic_63) {
+  Counters_t counters;
+  initializeCounters(&counters);
+  startCounters(&counters);
+
+  volatile unsigned int sum = 0;
+  for (unsigned int i = 0; i < 1000000; ++i) sum += i * i;
+
+  stopCounters(&counters);
+
+  // Unavailable counters are reported, available ones count this loop
+  bool isAll = true;
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+    if (counters.fds[i] < 0) ck_assert(!counters.isCounted[i]);
+    isAll = isAll && counters.fds[i] >= 0;
+  }
+  ck_assert_int_eq(isAll, counters.error == 0);
+  if (counters.isCounted[COUNTER_INSTRUCTIONS]) {
+    ck_assert_uint_gt(counters.values[COUNTER_INSTRUCTIONS], 1000000);
+  }
+
+  removeCounters(&counters);
+  for (int i = 0; i < COUNTERS_COUNT; ++i) {
+    ck_assert_int_eq(counters.fds[i], -1);
+  }
+}
+END_TEST
+
+// Counters of game played by a thread that has exited
+static void *playStatsGame(void *arg) {
+  GameParameters_t *params = arg;
+  unsigned int seed = 9;
+
+  processAction(params, Start);
+  while (params->state == GAME) {
+    processAction(params, (UserAction_t)(Left + getRandom(&seed) % 5));
+    updateTicks(params, params->ticks + 100);
+  }
+
+  return NULL;
+}
+
+// foldStats, readStats, writeStats and stats dumper
+START_TEST(tc_logic_64) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  initializeParametersPath(&params, NULL);
+  seedParameters(&params, 4);
+
+  unsigned long long before[STATS_COUNT];
+  unsigned long long after[STATS_COUNT];
+  readStats(before);
+
+  pthread_t thread;
+  ck_assert_int_eq(pthread_create(&thread, NULL, playStatsGame, &params), 0);
+  pthread_join(thread, NULL);
+
+  // Every spawn after the first one follows a lock, the last lock is folded
+  const unsigned long long *values = params.stats.values;
+  ck_assert_uint_eq(values[STAT_PIECES_LOCKED], params.spawnCount - 1);
+  ck_assert_uint_gt(values[STAT_COLLIDE_CHECKS], values[STAT_PIECES_LOCKED]);
+  ck_assert_uint_gt(values[STAT_GRAVITY_TICKS], 0);
+  ck_assert_uint_gt(values[STAT_ATTACH_NS], 0);
+  ck_assert_mem_eq(params.stats.folded, values, sizeof(params.stats.folded));
+
+  // Counters of exited thread are kept by global counters
+  readStats(after);
+  for (int i = 0; i < STATS_COUNT; ++i) {
+    ck_assert_uint_ge(after[i] - before[i], values[i]);
+  }
+
+  // Restart keeps counters of the previous game in global counters
+  params.stats.values[STAT_RENDER_NS] += 5;
+  processAction(&params, Start);
+  ck_assert_uint_eq(params.stats.values[STAT_PIECES_LOCKED], 0);
+  readStats(before);
+  ck_assert_uint_ge(before[STAT_RENDER_NS], after[STAT_RENDER_NS] + 5);
+
+  // Dumper writes stats file on signal
+  const char *path = "./tetris_test.stats";
+  StatsDumper_t dumper;
+  remove(path);
+  startStatsDumper(&dumper, path);
+  pthread_kill(dumper.thread, SIGUSR1);
+
+  FILE *file = NULL;
+  struct timespec delay = {.tv_sec = 0, .tv_nsec = 10000000};
+  for (int i = 0; i < 200 && !file; ++i) {
+    file = fopen(path, "r");
+    if (!file) nanosleep(&delay, NULL);
+  }
+  stopStatsDumper(&dumper);
+  ck_assert_ptr_nonnull(file);
+
+  char name[64];
+  unsigned long long value;
+  for (int i = 0; i < STATS_COUNT; ++i) {
+    ck_assert_int_eq(fscanf(file, "%63s %llu", name, &value), 2);
+    ck_assert_str_eq(name, getStatName((Stat_t)i));
+  }
+  fclose(file);
+  remove(path);
+
+  processAction(&params, Terminate);
+}
+END_TEST
+
+// Spans of thread that has exited
+static void *playTraceGame(void *arg) {
+  GameParameters_t *params = arg;
+
+  nameTraceThread("player");
+  processAction(params, Start);
+  while (params->state == GAME) updateTicks(params, params->ticks + 100);
+
+  return NULL;
+}
+
+// startTrace, beginTrace, endTrace, writeTrace and removeTrace
+START_TEST(tc_logic_65) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  params.data = &data;
+  params.figure = &figure;
+  initializeParametersPath(&params, NULL);
+  seedParameters(&params, 6);
+
+  // Spans are not recorded without trace
+  ck_assert(!isTraceActive());
+  ck_assert_int_eq(beginTrace(), 0);
+  endTrace("ignored", 1);
+
+  startTrace();
+  long long traceTime = beginTrace();
+  ck_assert_int_gt(traceTime, 0);
+
+  pthread_t thread;
+  ck_assert_int_eq(pthread_create(&thread, NULL, playTraceGame, &params), 0);
+  pthread_join(thread, NULL);
+  endTrace("test", traceTime);
+
+  const char *path = "./tetris_test.json";
+  ck_assert(writeTrace(path));
+  ck_assert(!isTraceActive());
+  removeTrace();
+
+  FILE *file = fopen(path, "r");
+  ck_assert_ptr_nonnull(file);
+  static char text[1 << 20];
+  size_t length = fread(text, 1, sizeof(text) - 1, file);
+  text[length] = '\0';
+  fclose(file);
+  remove(path);
+
+  ck_assert_ptr_nonnull(strstr(text, "{\"traceEvents\":["));
+  ck_assert_ptr_nonnull(strstr(text, "\"args\":{\"name\":\"player\"}"));
+  ck_assert_ptr_nonnull(strstr(text, "\"name\":\"gravity\""));
+  ck_assert_ptr_nonnull(strstr(text, "\"name\":\"line clear\""));
+  ck_assert_ptr_nonnull(strstr(text, "\"name\":\"test\""));
+  ck_assert_ptr_null(strstr(text, "ignored"));
+  ck_assert_ptr_nonnull(strstr(text, "\"dropped\":\"0\"}}"));
+
+  // Gravity spans of player and span of test are in different threads
+  const char *span = strstr(text, "\"name\":\"test\"");
+  ck_assert_ptr_nonnull(strstr(span, "\"tid\":"));
+  ck_assert_int_ne(atoi(strstr(span, "\"tid\":") + 6),
+                   atoi(strstr(strstr(text, "\"name\":\"gravity\""),
+                               "\"tid\":") +
+                        6));
+
+  // Buffers are made again after removeTrace
+  startTrace();
+  endTrace("again", beginTrace());
+  ck_assert(writeTrace(path));
+  removeTrace();
+  file = fopen(path, "r");
+  ck_assert_ptr_nonnull(file);
+  length = fread(text, 1, sizeof(text) - 1, file);
+  text[length] = '\0';
+  fclose(file);
+  remove(path);
+  ck_assert_ptr_nonnull(strstr(text, "\"name\":\"again\""));
+  ck_assert_ptr_null(strstr(text, "\"name\":\"test\""));
+
+  processAction(&params, Terminate);
+}
+END_TEST
+
+// Analytics of actions, pieces, ticks and game summaries
+START_TEST(tc_logic_66) {
+  GameParameters_t params;
+  GameInfo_t data;
+  Figure_t figure;
+  Bot_t bot;
+  params.data = &data;
+  params.figure = &figure;
+  initializeParametersPath(&params, NULL);
+  seedParameters(&params, 8);
+  initializeBot(&bot, NULL, 0);
+
+  const char *path = "./tetris_test.games";
+  remove(path);
+  ck_assert(!saveAnalytics(&params));
+  params.analyticsPath = path;
+
+  // Figure out of range isn't judged, spawn placement needs no inputs
+  ck_assert_int_eq(getMinimalInputs(FIGURES_COUNT, 0, FIELD_WIDTH / 2), -1);
+  ck_assert_int_eq(getMinimalInputs(0, ROTATIONS_COUNT, FIELD_WIDTH / 2), -1);
+  ck_assert_int_eq(getMinimalInputs(-1, -1, FIELD_WIDTH / 2), -1);
+  ck_assert_int_eq(getMinimalInputs(0, 0, FIELD_WIDTH / 2), 0);
+
+  // Drop from spawn position needs no inputs
+  processAction(&params, Start);
+  const Analytics_t *analytics = &data.analytics;
+  int height = getPiece(figure.type, 0)->height;
+  processAction(&params, Down);
+  ck_assert_uint_eq(analytics->pieces, 1);
+  ck_assert_uint_eq(analytics->faults, 0);
+  ck_assert_int_eq(analytics->maxHeight, height);
+
+  // Move back to spawn column is a fault, move by one column is not
+  processAction(&params, Left);
+  processAction(&params, Right);
+  processAction(&params, Down);
+  ck_assert_uint_eq(analytics->faults, 1);
+  processAction(&params, Left);
+  processAction(&params, Down);
+  ck_assert_uint_eq(analytics->faults, 1);
+  ck_assert_uint_eq(analytics->pieces, 3);
+  ck_assert_uint_eq(analytics->actions, 6);
+  ck_assert_uint_eq(analytics->inputs, 0);
+
+  // Paused ticks are not counted
+  updateTicks(&params, params.ticks + TICK_RATE);
+  processAction(&params, Pause);
+  updateTicks(&params, params.ticks + TICK_RATE);
+  processAction(&params, Pause);
+  ck_assert_uint_eq(analytics->ticks, TICK_RATE);
+  ck_assert_double_eq_tol(getAnalyticsPps(analytics), 3.0, 1e-9);
+  ck_assert_double_eq_tol(getAnalyticsApm(analytics), 360.0, 1e-9);
+
+  char text[ANALYTICS_TEXT_SIZE];
+  ck_assert_int_gt(formatAnalytics(analytics, 5, false, text, sizeof(text)),
+                   0);
+  ck_assert_ptr_nonnull(strstr(text, "\"pieces\":3,\"actions\":6,"));
+  ck_assert_ptr_nonnull(strstr(text, "\"faults\":1,"));
+  ck_assert_int_eq(formatAnalytics(analytics, 5, false, text, 16), -1);
+
+  // Clears match hot path counters, summary is appended at game over
+  while (params.state == GAME) {
+    UserAction_t action = getBotAction(&bot, &params);
+    processAction(&params, action == Up ? Down : action);
+    if (analytics->pieces > 300) processAction(&params, Down);
+  }
+  for (int i = 0; i < ANALYTICS_CLEARS; ++i) {
+    ck_assert_uint_eq(analytics->clears[i],
+                      params.stats.values[STAT_CLEARS_1 + i]);
+  }
+  ck_assert_uint_eq(analytics->pieces, params.stats.values[STAT_PIECES_LOCKED]);
+  ck_assert_int_gt(analytics->maxHeight, height);
+
+  // Terminated game is appended too, new game starts from zero
+  processAction(&params, Start);
+  ck_assert_uint_eq(analytics->pieces, 0);
+  processAction(&params, Down);
+  processAction(&params, Terminate);
+
+  FILE *file = fopen(path, "r");
+  ck_assert_ptr_nonnull(file);
+  ck_assert_ptr_nonnull(fgets(text, sizeof(text), file));
+  ck_assert_ptr_nonnull(strstr(text, "\"over\":true,"));
+  ck_assert_ptr_nonnull(fgets(text, sizeof(text), file));
+  ck_assert_ptr_nonnull(strstr(text, "\"over\":false,"));
+  ck_assert_ptr_nonnull(strstr(text, "\"pieces\":1,"));
+  ck_assert_ptr_null(fgets(text, sizeof(text), file));
+  fclose(file);
+  remove(path);
+}
+END_TEST
+
+// Input ring order, overflow and wrap-around, keys after ESC
+START_TEST(tc_logic_67) {
+  InputQueue_t queue;
+  InputEvent_t event;
+  initializeInputQueue(&queue);
+  ck_assert(!popInputEvent(&queue, &event));
+
+  // Full ring rejects push and keeps events in order
+  for (int i = 0; i < INPUT_QUEUE_SIZE; ++i) {
+    ck_assert(pushInputEvent(&queue, &(InputEvent_t){.key = i}));
+  }
+  ck_assert(!pushInputEvent(&queue, &(InputEvent_t){.key = -1}));
+  for (int i = 0; i < INPUT_QUEUE_SIZE; ++i) {
+    ck_assert(popInputEvent(&queue, &event));
+    ck_assert_int_eq(event.key, i);
+  }
+  ck_assert(!popInputEvent(&queue, &event));
+
+  // Indexes wrap around ring many times
+  for (int i = 0; i < INPUT_QUEUE_SIZE * 3; ++i) {
+    ck_assert(pushInputEvent(&queue, &(InputEvent_t){.key = i}));
+    ck_assert(pushInputEvent(&queue, &(InputEvent_t){.key = i + 1}));
+    ck_assert(popInputEvent(&queue, &event));
+    ck_assert_int_eq(event.key, i);
+    ck_assert(popInputEvent(&queue, &event));
+    ck_assert_int_eq(event.key, i + 1);
+  }
+  ck_assert(!popInputEvent(&queue, &event));
+
+  // Key after ESC is kept, truncated sequence is dropped without blocking
+  int fds[2];
+  int pending = ERR;
+  long long time = 0;
+  ck_assert_int_eq(pipe(fds), 0);
+  ck_assert_int_eq(write(fds[1], "\x1bq\x1b[C\x1b[1", 8), 8);
+  ck_assert_int_eq(readKey(fds[0], 0, &pending, &time), 27);
+  ck_assert_int_eq(readKey(fds[0], 0, &pending, &time), 'q');
+  ck_assert_int_eq(readKey(fds[0], 0, &pending, &time), KEY_RIGHT);
+  ck_assert_int_eq(readKey(fds[0], 0, &pending, &time), ERR);
+  ck_assert_int_eq(readKey(fds[0], 0, &pending, &time), ERR);
+  ck_assert_int_gt(time, 0);
+  close(fds[0]);
+  close(fds[1]);
+}
+END_TEST
+
 Suite *tetris_suite() {
   TCase *tc = tcase_create("[logic] cases");
   tcase_add_test(tc, tc_logic_1);
@@ -809,6 +2175,37 @@ Suite *tetris_suite() {
   tcase_add_test(tc, tc_logic_34);
   tcase_add_test(tc, tc_logic_35);
   tcase_add_test(tc, tc_logic_36);
+  tcase_add_test(tc, tc_logic_37);
+  tcase_add_test(tc, tc_logic_38);
+  tcase_add_test(tc, tc_logic_39);
+  tcase_add_test(tc, tc_logic_40);
+  tcase_add_test(tc, tc_logic_41);
+  tcase_add_test(tc, tc_logic_42);
+  tcase_add_test(tc, tc_logic_43);
+  tcase_add_test(tc, tc_logic_44);
+  tcase_add_test(tc, tc_logic_45);
+  tcase_add_test(tc, tc_logic_46);
+  tcase_add_test(tc, tc_logic_47);
+  tcase_add_test(tc, tc_logic_48);
+  tcase_add_test(tc, tc_logic_49);
+  tcase_add_test(tc, tc_logic_50);
+  tcase_add_test(tc, tc_logic_51);
+  tcase_add_test(tc, tc_logic_52);
+  tcase_add_test(tc, tc_logic_53);
+  tcase_add_test(tc, tc_logic_54);
+  tcase_add_test(tc, tc_logic_55);
+  tcase_add_test(tc, tc_logic_56);
+  tcase_add_test(tc, tc_logic_57);
+  tcase_add_test(tc, tc_logic_58);
+  tcase_add_test(tc, tc_logic_59);
+  tcase_add_test(tc, tc_logic_60);
+  tcase_add_test(tc, tc_logic_61);
+  tcase_add_test(tc, tc_logic_62);
+  tcase_add_test(tc, tc_logic_63);
+  tcase_add_test(tc, tc_logic_64);
+  tcase_add_test(tc, tc_logic_65);
+  tcase_add_test(tc, tc_logic_66);
+  tcase_add_test(tc, tc_logic_67);
 
   Suite *s = suite_create("[s21_tetris] suite");
   suite_add_tcase(s, tc);
@@ -7,13 +7,71 @@
  *****************************************************************************/
 
 #include "gui/cli/tetris_cli.h"
+#include "gui/cli/tetris_viewer.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+  Options_t options;
+  Bot_t bot;
+  static Beam_t beam;
+  static HashTable_t table;
+  static Rollout_t rollout;
+  static PerfectClear_t pc;
+  static StatsDumper_t dumper;
+
+  if (!parseOptions(argc, argv, &options)) {
+    printf("Usage: %s [--ansi] [--bot] [--rollout] [--hint] [--next N] "
+           "[--view N] [--trace PATH]\n",
+           argv[0]);
+    return 1;
+  }
+
+  // Before any thread, so SIGUSR1 is taken only by dumper
+  startStatsDumper(&dumper, STATS_PATH);
+  if (options.tracePath) startTrace();
   srand(time(NULL));
 
-  initGUI();
-  gameLoop();
-  destroyGUI();
+  if (options.viewGames > 0) {
+    initViewer();
+    viewerLoop(options.viewGames, options.isBot);
+    destroyViewer();
+  } else {
+    const Renderer_t *renderer = &renderers[options.renderer];
+    initializeBot(&bot, NULL, BOT_BUDGET);
+    if (options.isHint) {
+      initializePerfectClear(&pc, PC_DB_PATH, HASH_TABLE_BITS);
+      hint.pc = &pc;
+      bot.pc = &pc;
+    }
+    if (options.isRollout) {
+      initializeRollout(&rollout, ROLLOUT_DEPTH, 0, (uint64_t)time(NULL));
+      bot.rollout = &rollout;
+    } else if (options.isBot && options.queueLength > 1) {
+      initializeBeam(&beam, BEAM_WIDTH, 0);
+      initializeHashTable(&table, HASH_TABLE_BITS);
+      beam.table = &table;
+      bot.beam = &beam;
+    }
+
+    renderer->init();
+    gameLoop(renderer, options.queueLength, options.isBot ? &bot : NULL);
+    renderer->destroy();
+
+    if (bot.beam) {
+      removeBeam(bot.beam);
+      removeHashTable(&table);
+    }
+    if (bot.rollout) removeRollout(bot.rollout);
+    if (hint.pc) removePerfectClear(hint.pc);
+  }
+
+  stopStatsDumper(&dumper);
+
+  if (options.tracePath) {
+    if (!writeTrace(options.tracePath)) {
+      printf("Error: Unable to write trace (%s)\n", options.tracePath);
+    }
+    removeTrace();
+  }
 
   return 0;
 }
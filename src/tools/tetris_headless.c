@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * @file tetris_headless.c
+ * @brief Headless Bot Runner of the Tetris Game
+ *
+ * Play seeded games by bots on all CPUs without terminal as fast as logic
+ *allows. Deterministic load for soak tests and benchmarks
+ *****************************************************************************/
+
+#include "tetris_headless.h"
+
+#include <string.h>
+
+static Simulation_t simulation;
+static Beam_t beams[SIM_GAMES_MAX];
+static HashTable_t table;
+static Rollout_t rollouts[SIM_GAMES_MAX];
+static Expectimax_t expects[SIM_GAMES_MAX];
+static StatsDumper_t dumper;
+
+int main(int argc, char *argv[]) {
+  HeadlessOptions_t options;
+
+  if (!parseHeadlessOptions(argc, argv, &options)) {
+    printf(
+        "Usage: %s [--games N] [--pieces N] [--threads N] [--seed N] "
+        "[--budget US] [--next N] [--width N] [--workers N] [--table BITS] "
+        "[--rollout DEPTH] [--expect DEPTH] [--counters 0|1]\n",
+        argv[0]);
+    return 1;
+  }
+
+  // Before any thread, so SIGUSR1 is taken only by dumper
+  startStatsDumper(&dumper, STATS_PATH);
+  runHeadless(&options);
+  stopStatsDumper(&dumper);
+
+  return 0;
+}
+
+bool parseHeadlessOptions(int argc, char *argv[], HeadlessOptions_t *options) {
+  bool isValid = true;
+  options->games = HEADLESS_GAMES;
+  options->pieces = HEADLESS_PIECES;
+  options->threads = 0;
+  options->seed = HEADLESS_SEED;
+  options->budget = BOT_BUDGET;
+  options->queueLength = 1;
+  options->width = BEAM_WIDTH;
+  options->workers = HEADLESS_WORKERS;
+  options->tableBits = HASH_TABLE_BITS;
+  options->rolloutDepth = 0;
+  options->expectDepth = 0;
+  options->isCounters = false;
+
+  // Every option has a value
+  for (int i = 1; i + 1 < argc && isValid; i += 2) {
+    const char *value = argv[i + 1];
+
+    if (strcmp(argv[i], "--games") == 0) {
+      options->games = atoi(value);
+      isValid = options->games > 0 && options->games <= SIM_GAMES_MAX;
+    } else if (strcmp(argv[i], "--pieces") == 0) {
+      options->pieces = strtoul(value, NULL, 10);
+      isValid = options->pieces > 0;
+    } else if (strcmp(argv[i], "--threads") == 0) {
+      options->threads = atoi(value);
+      isValid = options->threads >= 0;
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      options->seed = (unsigned int)strtoul(value, NULL, 10);
+    } else if (strcmp(argv[i], "--budget") == 0) {
+      options->budget = atoll(value) * 1000;
+      isValid = options->budget >= 0;
+    } else if (strcmp(argv[i], "--next") == 0) {
+      options->queueLength = atoi(value);
+      isValid = options->queueLength > 0 && options->queueLength <= QUEUE_MAX;
+    } else if (strcmp(argv[i], "--width") == 0) {
+      options->width = atoi(value);
+      isValid = options->width > 0 && options->width <= BEAM_WIDTH_MAX;
+    } else if (strcmp(argv[i], "--workers") == 0) {
+      options->workers = atoi(value);
+      isValid = options->workers >= 0;
+    } else if (strcmp(argv[i], "--table") == 0) {
+      options->tableBits = atoi(value);
+      isValid = options->tableBits >= 0 &&
+                options->tableBits <= HEADLESS_TABLE_BITS_MAX;
+    } else if (strcmp(argv[i], "--rollout") == 0) {
+      options->rolloutDepth = atoi(value);
+      isValid = options->rolloutDepth >= 0;
+    } else if (strcmp(argv[i], "--expect") == 0) {
+      options->expectDepth = atoi(value);
+      isValid = options->expectDepth >= 0 &&
+                options->expectDepth <= EXPECT_DEPTH_MAX;
+    } else if (strcmp(argv[i], "--counters") == 0) {
+      options->isCounters = atoi(value) != 0;
+    } else {
+      isValid = false;
+    }
+  }
+
+  return isValid && argc % 2 == 1;
+}
+
+void runHeadless(const HeadlessOptions_t *options) {
+  // Counters are opened before any thread, so they count all of them
+  Counters_t counters = {0};
+  if (options->isCounters) initializeCounters(&counters);
+
+  initializeSimulation(&simulation, options->games, options->seed);
+  initializeSimulationBots(&simulation, options->budget);
+  simulation.spawnLimit = options->pieces;
+
+  // One table is shared by beams of all games, they use the same weights
+  bool isRollout = options->rolloutDepth > 0;
+  bool isExpect = !isRollout && options->expectDepth > 0;
+  bool isBeam = !isRollout && !isExpect && options->queueLength > 1;
+  bool isTable = isBeam && options->tableBits > 0;
+  if (isTable) initializeHashTable(&table, options->tableBits);
+
+  for (int i = 0; i < simulation.gamesCount; ++i) {
+    SimGame_t *game = &simulation.games[i];
+
+    if (isRollout) {
+      initializeRollout(&rollouts[i], options->rolloutDepth, options->workers,
+                        options->seed + (unsigned int)i);
+      game->bot.rollout = &rollouts[i];
+    } else if (isExpect) {
+      setQueueLength(&game->parameters, options->queueLength);
+      initializeExpectimax(&expects[i], options->expectDepth, NULL,
+                           options->tableBits);
+      game->bot.expect = &expects[i];
+    } else if (isBeam) {
+      setQueueLength(&game->parameters, options->queueLength);
+      initializeBeam(&beams[i], options->width, options->workers);
+      beams[i].table = isTable ? &table : NULL;
+      game->bot.beam = &beams[i];
+    }
+  }
+
+  if (options->isCounters) startCounters(&counters);
+  long long start = getBotTime();
+  startSimulation(&simulation, options->threads);
+  waitSimulation(&simulation);
+  double seconds = (double)(getBotTime() - start) / 1e9;
+  if (options->isCounters) stopCounters(&counters);
+
+  unsigned long pieces = 0;
+  unsigned long ticks = 0;
+  unsigned long gameOvers = 0;
+  long long score = 0;
+
+  for (int i = 0; i < simulation.gamesCount; ++i) {
+    SimGame_t *game = &simulation.games[i];
+    pieces += game->parameters.spawnCount;
+    ticks += game->parameters.ticks;
+    gameOvers += game->games;
+    score += game->data.score;
+    printf("game %d: score %d, level %d, game overs %lu\n", i,
+           game->data.score, game->data.level, game->games);
+  }
+
+  printf("pieces: %lu\n", pieces);
+  printf("game overs: %lu\n", gameOvers);
+  printf("mean score: %.1f\n", (double)score / simulation.gamesCount);
+  printf("time: %.3f s\n", seconds);
+  printf("pieces/sec: %.0f\n", seconds > 0 ? (double)pieces / seconds : 0.0);
+
+  if (isRollout) {
+    double rate = 0;
+    for (int i = 0; i < simulation.gamesCount; ++i) {
+      rate += getRolloutRate(&rollouts[i]);
+    }
+    printf("rollouts/sec: %.0f\n", rate);
+  }
+
+  if (options->isCounters) {
+    CounterUnit_t units[] = {{"tick", (double)ticks},
+                             {"placement", (double)pieces}};
+    printCounters(&counters, units, 2);
+    removeCounters(&counters);
+  }
+
+  for (int i = 0; i < simulation.gamesCount; ++i) {
+    if (isRollout) removeRollout(&rollouts[i]);
+    if (isExpect) removeExpectimax(&expects[i]);
+    if (isBeam) removeBeam(&beams[i]);
+  }
+
+  if (isTable) removeHashTable(&table);
+
+  removeSimulation(&simulation);
+}
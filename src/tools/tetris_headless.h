@@ -0,0 +1,81 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/*****************************************************************************
+ * @file tetris_headless.h
+ * @brief Header File with Headless Bot Runner of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../brick_game/tetris/tetris_counters.h"
+#include "../brick_game/tetris/tetris_sim.h"
+
+#define HEADLESS_GAMES 1
+#define HEADLESS_PIECES 10000
+#define HEADLESS_SEED 1
+#define HEADLESS_WORKERS 1
+#define HEADLESS_TABLE_BITS_MAX 28
+
+/*****************************************************************************
+ * @brief Headless options struct
+ *
+ * @param games Number of games: [1..SIM_GAMES_MAX]
+ * @param pieces Number of figures of every game
+ * @param threads Number of threads, 0 for number of online CPUs
+ * @param seed Seed of the first game
+ * @param budget Time of bot search per figure in ns
+ * @param queueLength Number of upcoming figures, bots use beam search if > 1
+ * @param width Number of nodes kept by beam search on every depth
+ * @param workers Number of beam search threads of every game
+ * @param rolloutDepth Number of figures of Monte Carlo rollouts, bots use
+ *rollout search instead of evaluation if > 0
+ * @param expectDepth Number of plies of expectimax, bots use expectimax
+ *search if > 0
+ * @param tableBits Size of transposition table shared by beams or of every
+ *expectimax: 1 << bits entries, 0 for no table of beams
+ * @param isCounters Flag to report hardware counters of simulation
+ *****************************************************************************/
+typedef struct {
+  int games;
+  unsigned long pieces;
+  int threads;
+  unsigned int seed;
+  long long budget;
+  int queueLength;
+  int width;
+  int workers;
+  int tableBits;
+  int rolloutDepth;
+  int expectDepth;
+  bool isCounters;
+} HeadlessOptions_t;
+
+/*****************************************************************************
+ * @brief Parse command line options
+ *
+ * Parse [--games N] [--pieces N] [--threads N] [--seed N] [--budget US]
+ *[--next N] [--width N] [--workers N] [--table BITS] [--rollout DEPTH]
+ *[--expect DEPTH] [--counters 0|1]
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Pointer to struct of HeadlessOptions_t to fill
+ * @return bool False if options are invalid
+ *****************************************************************************/
+bool parseHeadlessOptions(int argc, char *argv[], HeadlessOptions_t *options);
+
+/*****************************************************************************
+ * @brief Run headless games
+ *
+ * Play games by bots until every game has spawned the number of figures,
+ *print figures, game overs, scores and speed, rollouts per second of rollout
+ *bots
+ *
+ * @param options Pointer to struct of HeadlessOptions_t
+ *****************************************************************************/
+void runHeadless(const HeadlessOptions_t *options);
+
+#endif  // HEADLESS_H
@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * @file tetris_pcdb.c
+ * @brief Perfect Clear Database Builder of the Tetris Game
+ *
+ * Precompute regions of the lowest rows that some figures can clear. The
+ *solver maps the file at startup and skips regions that can't be cleared
+ *****************************************************************************/
+
+#include "tetris_pcdb.h"
+
+int main(int argc, char *argv[]) {
+  if (argc > 2) {
+    printf("Usage: %s [PATH]\n", argv[0]);
+    return 1;
+  }
+
+  return runPcDatabase(argc > 1 ? argv[1] : PC_DB_PATH) ? 0 : 1;
+}
+
+bool runPcDatabase(const char *path) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  unsigned long count = buildPcDatabase(path);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double seconds = (double)(end.tv_sec - start.tv_sec) +
+                   (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+  if (count > 0) {
+    printf("solvable regions: %lu\n", count);
+    printf("time: %.3f s\n", seconds);
+  } else {
+    printf("Error: Unable to write database (%s)\n", path);
+  }
+
+  return count > 0;
+}
@@ -0,0 +1,25 @@
+#ifndef PCDB_H
+#define PCDB_H
+
+/*****************************************************************************
+ * @file tetris_pcdb.h
+ * @brief Header File with Perfect Clear Database Builder
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../brick_game/tetris/tetris_pc.h"
+
+/*****************************************************************************
+ * @brief Run database builder
+ *
+ * Build database, print number of solvable regions and time
+ *
+ * @param path Path of database
+ * @return bool False if database can't be written
+ *****************************************************************************/
+bool runPcDatabase(const char *path);
+
+#endif  // PCDB_H
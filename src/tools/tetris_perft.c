@@ -0,0 +1,326 @@
+/*****************************************************************************
+ * @file tetris_perft.c
+ * @brief Placement Counter of the Tetris Game
+ *
+ * Count every distinct sequence of placements of a fixed figure sequence,
+ *like chess perft. Deterministic workload for benchmarking and a check that
+ *board and game logic agree on collision, attach and row removal
+ *****************************************************************************/
+
+#include "tetris_perft.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[]) {
+  PerftOptions_t options;
+  Board_t board;
+
+  if (!parsePerftOptions(argc, argv, &options)) {
+    printf(
+        "Usage: %s [--divide] [--engine] [--counters] [--board FILE] "
+        "SEQUENCE DEPTH\n",
+        argv[0]);
+    return 1;
+  }
+
+  resetBoard(&board);
+  if (options.boardPath && !readBoard(options.boardPath, &board)) {
+    printf("Error: Unable to read board (%s)\n", options.boardPath);
+    return 1;
+  }
+
+  runPerft(&board, &options);
+
+  return 0;
+}
+
+bool parsePerftOptions(int argc, char *argv[], PerftOptions_t *options) {
+  bool isValid = true;
+  int positional = 0;
+  options->length = 0;
+  options->depth = 0;
+  options->isDivide = false;
+  options->isEngine = false;
+  options->isCounters = false;
+  options->boardPath = NULL;
+
+  for (int i = 1; i < argc && isValid; ++i) {
+    if (strcmp(argv[i], "--divide") == 0) {
+      options->isDivide = true;
+    } else if (strcmp(argv[i], "--engine") == 0) {
+      options->isEngine = true;
+    } else if (strcmp(argv[i], "--counters") == 0) {
+      options->isCounters = true;
+    } else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+      options->boardPath = argv[++i];
+    } else if (positional == 0) {
+      for (int j = 0; argv[i][j] && isValid; ++j) {
+        int type = getFigureType(argv[i][j]);
+        isValid = type >= 0 && options->length < PERFT_SEQUENCE_MAX;
+        if (isValid) options->sequence[options->length++] = type;
+      }
+      ++positional;
+    } else if (positional == 1) {
+      options->depth = atoi(argv[i]);
+      ++positional;
+    } else {
+      isValid = false;
+    }
+  }
+
+  return isValid && positional == 2 && options->length > 0 &&
+         options->depth >= 0;
+}
+
+int getFigureType(char letter) {
+  const char *letters = "IJLOSTZ";  // In order of figures
+  const char *found = strchr(letters, letter);
+
+  return letter && found ? (int)(found - letters) : -1;
+}
+
+bool readBoard(const char *path, Board_t *board) {
+  char lines[FIELD_HEIGHT][PERFT_LINE_SIZE];
+  int count = 0;
+  bool isValid = true;
+  FILE *file = fopen(path, "r");
+
+  if (!file) {
+    isValid = false;
+  } else {
+    char line[PERFT_LINE_SIZE];
+
+    while (isValid && fgets(line, sizeof(line), file)) {
+      isValid = count < FIELD_HEIGHT - BORDER_SIZE * 2;
+      if (isValid) strcpy(lines[count++], line);
+    }
+
+    fclose(file);
+  }
+
+  for (int i = 0; i < count && isValid; ++i) {
+    int row = FIELD_HEIGHT - BORDER_SIZE - count + i;
+
+    for (int col = 0; col < FIELD_WIDTH - BORDER_SIZE * 2; ++col) {
+      char pixel = lines[i][col];
+      if (pixel == '\n' || pixel == '\r' || pixel == '\0') break;
+
+      if (pixel != '.' && pixel != ' ') {
+        board->rows[row] |= (uint16_t)(1u << (col + BORDER_SIZE));
+      }
+    }
+  }
+
+  return isValid;
+}
+
+unsigned long long perft(const Board_t *board, const PerftOptions_t *options,
+                         int index, int depth) {
+  unsigned long long nodes = depth == 0;
+  Figure_t figure;
+  int type = options->sequence[index % options->length];
+
+  if (depth > 0 && spawnBoardFigure(board, type, &figure)) {
+    Placement_t placements[PLACEMENTS_MAX];
+    int count = generatePlacements(board, &figure, placements);
+
+    if (depth == 1) {
+      nodes = (unsigned long long)count;
+    } else {
+      for (int i = 0; i < count; ++i) {
+        Board_t next = *board;
+        placePiece(&next, getPiece(type, placements[i].rotation),
+                   placements[i].x, placements[i].y);
+        nodes += perft(&next, options, index + 1, depth - 1);
+      }
+    }
+  }
+
+  return nodes;
+}
+
+unsigned long long perftEngine(GameParameters_t *parameters,
+                               const PerftOptions_t *options, int index,
+                               int depth) {
+  unsigned long long nodes = depth == 0;
+  Figure_t *figure = parameters->figure;
+  figure->type = options->sequence[index % options->length];
+  figure->rotation = 0;
+  figure->x = FIELD_WIDTH / 2;
+  figure->y = 3;
+
+  if (depth > 0 && isFigureNotCollide(parameters)) {
+    Placement_t placements[PLACEMENTS_MAX];
+    int count = generateEnginePlacements(parameters, placements);
+    int type = figure->type;
+    int saved[FIELD_HEIGHT][FIELD_WIDTH];
+
+    for (int row = 0; row < FIELD_HEIGHT; ++row) {
+      memcpy(saved[row], parameters->data->field[row], sizeof(saved[row]));
+    }
+
+    for (int i = 0; i < count; ++i) {
+      figure->type = type;
+      figure->x = placements[i].x;
+      figure->y = placements[i].y;
+      figure->rotation = placements[i].rotation;
+      addFigure(parameters);
+      removeFullRows(parameters);
+
+      nodes += perftEngine(parameters, options, index + 1, depth - 1);
+
+      for (int row = 0; row < FIELD_HEIGHT; ++row) {
+        memcpy(parameters->data->field[row], saved[row], sizeof(saved[row]));
+      }
+    }
+  }
+
+  return nodes;
+}
+
+int generateEnginePlacements(GameParameters_t *parameters,
+                             Placement_t *placements) {
+  Figure_t *figure = parameters->figure;
+  Figure_t start = *figure;
+  bool tested[ROTATIONS_COUNT][FIELD_HEIGHT][FIELD_WIDTH] = {{{false}}};
+  bool reachable[ROTATIONS_COUNT][FIELD_HEIGHT][FIELD_WIDTH] = {{{false}}};
+  bool placed[ROTATIONS_COUNT][FIELD_HEIGHT][FIELD_WIDTH] = {{{false}}};
+  Placement_t queue[PLACEMENTS_MAX];
+  int head = 0;
+  int tail = 0;
+  int count = 0;
+
+  tested[start.rotation][start.y][start.x] = true;
+  if (isFigureNotCollide(parameters)) {
+    reachable[start.rotation][start.y][start.x] = true;
+    queue[tail++] = (Placement_t){(unsigned char)start.x,
+                                  (unsigned char)start.y,
+                                  (unsigned char)start.rotation};
+  }
+
+  while (head < tail) {
+    Placement_t state = queue[head++];
+    int moves[4][3] = {{state.x - 1, state.y, state.rotation},
+                       {state.x + 1, state.y, state.rotation},
+                       {state.x, state.y, (state.rotation + 1) % 4},
+                       {state.x, state.y + 1, state.rotation}};
+
+    for (int i = 0; i < 4; ++i) {
+      int x = moves[i][0], y = moves[i][1], rotation = moves[i][2];
+
+      if (!tested[rotation][y][x]) {
+        tested[rotation][y][x] = true;
+        figure->x = x;
+        figure->y = y;
+        figure->rotation = rotation;
+
+        if (isFigureNotCollide(parameters)) {
+          reachable[rotation][y][x] = true;
+          queue[tail++] = (Placement_t){(unsigned char)x, (unsigned char)y,
+                                        (unsigned char)rotation};
+        }
+      }
+    }
+
+    if (!reachable[state.rotation][state.y + 1][state.x]) {
+      const Piece_t *piece = getPiece(start.type, state.rotation);
+      bool *shape =
+          &placed[piece->shape][state.y + piece->top][state.x + piece->left];
+
+      if (!*shape) {
+        *shape = true;
+        placements[count++] = state;
+      }
+    }
+  }
+
+  *figure = start;
+
+  return count;
+}
+
+void runPerft(const Board_t *board, const PerftOptions_t *options) {
+  GameParameters_t parameters;
+  GameInfo_t data;
+  Figure_t figure;
+  parameters.data = &data;
+  parameters.figure = &figure;
+  data.field = allocate2DArray(FIELD_HEIGHT, FIELD_WIDTH);
+  data.next = NULL;
+
+  for (int row = 0; row < FIELD_HEIGHT; ++row) {
+    for (int col = 0; col < FIELD_WIDTH; ++col) {
+      data.field[row][col] = board->rows[row] >> col & 1;
+    }
+  }
+
+  Counters_t counters = {0};
+  if (options->isCounters) {
+    initializeCounters(&counters);
+    startCounters(&counters);
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  unsigned long long nodes = options->depth == 0;
+  int type = options->sequence[0];
+  Placement_t placements[PLACEMENTS_MAX];
+  int count = 0;
+
+  if (options->depth > 0 && spawnBoardFigure(board, type, &figure)) {
+    count = options->isEngine ? generateEnginePlacements(&parameters,
+                                                         placements)
+                              : generatePlacements(board, &figure, placements);
+  }
+
+  for (int i = 0; i < count; ++i) {
+    unsigned long long children;
+    const Piece_t *piece = getPiece(type, placements[i].rotation);
+
+    if (options->isEngine) {
+      figure.type = type;
+      figure.x = placements[i].x;
+      figure.y = placements[i].y;
+      figure.rotation = placements[i].rotation;
+      addFigure(&parameters);
+      removeFullRows(&parameters);
+      children = perftEngine(&parameters, options, 1, options->depth - 1);
+
+      for (int row = 0; row < FIELD_HEIGHT; ++row) {
+        for (int col = 0; col < FIELD_WIDTH; ++col) {
+          data.field[row][col] = board->rows[row] >> col & 1;
+        }
+      }
+    } else {
+      Board_t next = *board;
+      placePiece(&next, piece, placements[i].x, placements[i].y);
+      children = perft(&next, options, 1, options->depth - 1);
+    }
+
+    if (options->isDivide) {
+      printf("r%d x%d y%d: %llu\n", placements[i].rotation,
+             placements[i].x + piece->left - BORDER_SIZE,
+             placements[i].y + piece->top - BORDER_SIZE, children);
+    }
+
+    nodes += children;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (options->isCounters) stopCounters(&counters);
+  double seconds =
+      (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("nodes: %llu\n", nodes);
+  printf("time: %.3f s\n", seconds);
+  printf("nodes/sec: %.0f\n", seconds > 0 ? (double)nodes / seconds : 0.0);
+
+  if (options->isCounters) {
+    CounterUnit_t unit = {"node", (double)nodes};
+    printCounters(&counters, &unit, 1);
+    removeCounters(&counters);
+  }
+
+  removeParameters(&parameters);
+}
@@ -0,0 +1,126 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+/*****************************************************************************
+ * @file tetris_perft.h
+ * @brief Header File with Placement Counter of the Tetris Game
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../brick_game/tetris/tetris_board.h"
+#include "../brick_game/tetris/tetris_counters.h"
+#include "../brick_game/tetris/tetris_logic.h"
+
+#define PERFT_SEQUENCE_MAX 64
+#define PERFT_LINE_SIZE 64
+
+/*****************************************************************************
+ * @brief Perft options struct
+ *
+ * @param sequence Types of figures, repeated if shorter than depth
+ * @param length Number of figures in sequence
+ * @param depth Number of placements in every counted sequence
+ * @param isDivide Flag to print counts of every first placement
+ * @param isEngine Flag to count with game logic field instead of board
+ * @param isCounters Flag to report hardware counters of counting
+ * @param boardPath Path to board file or NULL for empty board
+ *****************************************************************************/
+typedef struct {
+  int sequence[PERFT_SEQUENCE_MAX];
+  int length;
+  int depth;
+  bool isDivide;
+  bool isEngine;
+  bool isCounters;
+  const char *boardPath;
+} PerftOptions_t;
+
+/*****************************************************************************
+ * @brief Parse command line options
+ *
+ * Parse [--divide] [--engine] [--counters] [--board FILE] SEQUENCE DEPTH,
+ *where SEQUENCE is a string of figure letters IJLOSTZ
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Pointer to struct of PerftOptions_t to fill
+ * @return bool False if options are invalid
+ *****************************************************************************/
+bool parsePerftOptions(int argc, char *argv[], PerftOptions_t *options);
+
+/*****************************************************************************
+ * @brief Get figure type by letter
+ *
+ * @param letter One of IJLOSTZ
+ * @return int Type of figure or -1 for unknown letter
+ *****************************************************************************/
+int getFigureType(char letter);
+
+/*****************************************************************************
+ * @brief Read board
+ *
+ * Read board file: rows of 10 pixels, '.' for empty pixel and any other
+ *char for filled one. The last row of file is the bottom row of field
+ *
+ * @param path Path to board file
+ * @param board Pointer to struct of Board_t to fill
+ * @return bool False if file can't be read or has too many rows
+ *****************************************************************************/
+bool readBoard(const char *path, Board_t *board);
+
+/*****************************************************************************
+ * @brief Count placement sequences on board
+ *
+ * @param board Pointer to struct of Board_t
+ * @param options Pointer to struct of PerftOptions_t
+ * @param index Index of figure in sequence
+ * @param depth Number of placements left
+ * @return unsigned long long Number of placement sequences
+ *****************************************************************************/
+unsigned long long perft(const Board_t *board, const PerftOptions_t *options,
+                         int index, int depth);
+
+/*****************************************************************************
+ * @brief Count placement sequences on game field
+ *
+ * Count with isFigureNotCollide, addFigure and removeFullRows of game logic
+ *instead of board, the result must be equal to perft
+ *
+ * @param parameters Pointer to struct of GameParameters_t
+ * @param options Pointer to struct of PerftOptions_t
+ * @param index Index of figure in sequence
+ * @param depth Number of placements left
+ * @return unsigned long long Number of placement sequences
+ *****************************************************************************/
+unsigned long long perftEngine(GameParameters_t *parameters,
+                               const PerftOptions_t *options, int index,
+                               int depth);
+
+/*****************************************************************************
+ * @brief Generate placements on game field
+ *
+ * The same search as generatePlacements with isFigureNotCollide
+ *
+ * @param parameters Pointer to struct of GameParameters_t with figure to
+ *start from, field must not contain figure
+ * @param placements Array of at least PLACEMENTS_MAX placements to fill
+ * @return int Number of placements
+ *****************************************************************************/
+int generateEnginePlacements(GameParameters_t *parameters,
+                             Placement_t *placements);
+
+/*****************************************************************************
+ * @brief Run perft
+ *
+ * Count placement sequences from start position, print counts of first
+ *placements if requested, total count and speed
+ *
+ * @param board Pointer to start board
+ * @param options Pointer to struct of PerftOptions_t
+ *****************************************************************************/
+void runPerft(const Board_t *board, const PerftOptions_t *options);
+
+#endif  // PERFT_H
@@ -0,0 +1,408 @@
+/*****************************************************************************
+ * @file tetris_tune.c
+ * @brief Genetic Tuner of Evaluation Weights of the Tetris Game
+ *
+ * Evolve weights of board evaluation by rows removed in fixed seeded games
+ *played on all CPUs without terminal. Population is written to checkpoint
+ *after every generation, so a stopped run resumes where it was
+ *****************************************************************************/
+
+#include "tetris_tune.h"
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+
+static Population_t population;
+static Tuner_t tuner;
+
+static uint64_t getTuneRandom(uint64_t *random) {
+  // xorshift64*
+  *random ^= *random >> 12;
+  *random ^= *random << 25;
+  *random ^= *random >> 27;
+
+  return *random * 0x2545F4914F6CDD1Dull;
+}
+
+static double getTuneGaussian(uint64_t *random) {
+  // Box-Muller transform of two uniform numbers of (0, 1] and [0, 1)
+  double u = (double)((getTuneRandom(random) >> 11) + 1) * 0x1.0p-53;
+  double v = (double)(getTuneRandom(random) >> 11) * 0x1.0p-53;
+
+  return sqrt(-2.0 * log(u)) * cos(2.0 * acos(-1.0) * v);
+}
+
+static void normalizeWeights(Weights_t *weights) {
+  double length = 0;
+  for (int i = 0; i < FEATURES_COUNT; ++i) {
+    length += (double)weights->values[i] * weights->values[i];
+  }
+
+  length = sqrt(length);
+  for (int i = 0; i < FEATURES_COUNT && length > 0; ++i) {
+    weights->values[i] = (float)(weights->values[i] / length);
+  }
+}
+
+static void mutateWeights(Weights_t *weights, uint64_t *random) {
+  int feature = (int)(getTuneRandom(random) % FEATURES_COUNT);
+
+  weights->values[feature] += (float)(getTuneGaussian(random) * TUNE_SIGMA);
+  normalizeWeights(weights);
+}
+
+// Tournament of two candidates of sorted population
+static int selectParent(Population_t *population) {
+  int a = (int)(getTuneRandom(&population->random) % population->count);
+  int b = (int)(getTuneRandom(&population->random) % population->count);
+
+  return a < b ? a : b;
+}
+
+static long long getTuneTime(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (long long)time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static void evaluateGeneration(Tuner_t *tuner, int threadsCount) {
+  Population_t *population = tuner->population;
+  long long start = getTuneTime();
+  double mean = 0;
+
+  evaluatePopulation(tuner, threadsCount);
+  sortPopulation(population);
+
+  for (int i = 0; i < population->count; ++i) mean += population->fitness[i];
+  mean /= population->count;
+
+  printf(
+      "generation %d: best %.1f, mean %.1f, played %lu, cached %lu, "
+      "time %.3f s\n",
+      population->generation, population->fitness[0], mean,
+      atomic_load(&tuner->played), atomic_load(&tuner->cached),
+      (double)(getTuneTime() - start) / 1e9);
+}
+
+int main(int argc, char *argv[]) {
+  TuneOptions_t options;
+
+  if (!parseTuneOptions(argc, argv, &options)) {
+    printf(
+        "Usage: %s [--population N] [--generations N] [--games N] "
+        "[--pieces N] [--threads N] [--seed N] [--checkpoint PATH]\n",
+        argv[0]);
+    return 1;
+  }
+
+  runTune(&options);
+
+  return 0;
+}
+
+bool parseTuneOptions(int argc, char *argv[], TuneOptions_t *options) {
+  bool isValid = true;
+  options->population = TUNE_POPULATION;
+  options->generations = TUNE_GENERATIONS;
+  options->games = TUNE_GAMES;
+  options->pieces = TUNE_PIECES;
+  options->threads = 0;
+  options->seed = TUNE_SEED;
+  options->checkpointPath = TUNE_CHECKPOINT_PATH;
+
+  // Every option has a value
+  for (int i = 1; i + 1 < argc && isValid; i += 2) {
+    const char *value = argv[i + 1];
+
+    if (strcmp(argv[i], "--population") == 0) {
+      options->population = atoi(value);
+      isValid = options->population > 1 &&
+                options->population <= TUNE_POPULATION_MAX;
+    } else if (strcmp(argv[i], "--generations") == 0) {
+      options->generations = atoi(value);
+      isValid = options->generations >= 0;
+    } else if (strcmp(argv[i], "--games") == 0) {
+      options->games = atoi(value);
+      isValid = options->games > 0 && options->games <= TUNE_GAMES_MAX;
+    } else if (strcmp(argv[i], "--pieces") == 0) {
+      options->pieces = strtoul(value, NULL, 10);
+      isValid = options->pieces > 0;
+    } else if (strcmp(argv[i], "--threads") == 0) {
+      options->threads = atoi(value);
+      isValid = options->threads >= 0;
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      options->seed = (unsigned int)strtoul(value, NULL, 10);
+    } else if (strcmp(argv[i], "--checkpoint") == 0) {
+      options->checkpointPath = value;
+    } else {
+      isValid = false;
+    }
+  }
+
+  return isValid && argc % 2 == 1;
+}
+
+void initializePopulation(Population_t *population, int count,
+                          unsigned int seed) {
+  population->count = count;
+  population->generation = 0;
+  population->random = ((uint64_t)seed + 1) * 0x9E3779B97F4A7C15ull;
+  population->candidates[0] = defaultWeights;
+  normalizeWeights(&population->candidates[0]);
+
+  for (int i = 0; i < count; ++i) {
+    population->fitness[i] = 0;
+
+    if (i > 0) {
+      population->candidates[i] = population->candidates[0];
+      for (int k = 0; k < FEATURES_COUNT; ++k) {
+        mutateWeights(&population->candidates[i], &population->random);
+      }
+    }
+  }
+}
+
+bool readCheckpoint(const char *path, Population_t *population) {
+  char magic[TUNE_MAGIC_SIZE];
+  int features = 0;
+  FILE *file = fopen(path, "rb");
+
+  bool isValid =
+      file && fread(magic, 1, TUNE_MAGIC_SIZE, file) == TUNE_MAGIC_SIZE &&
+      memcmp(magic, TUNE_MAGIC, TUNE_MAGIC_SIZE) == 0 &&
+      fread(&features, sizeof(features), 1, file) == 1 &&
+      features == FEATURES_COUNT &&
+      fread(&population->count, sizeof(population->count), 1, file) == 1 &&
+      population->count > 1 && population->count <= TUNE_POPULATION_MAX &&
+      fread(&population->generation, sizeof(population->generation), 1,
+            file) == 1 &&
+      fread(&population->random, sizeof(population->random), 1, file) == 1;
+
+  for (int i = 0; isValid && i < population->count; ++i) {
+    isValid = fread(population->candidates[i].values, sizeof(float),
+                    FEATURES_COUNT, file) == FEATURES_COUNT;
+    population->fitness[i] = 0;
+  }
+
+  if (file) fclose(file);
+
+  return isValid;
+}
+
+bool writeCheckpoint(const char *path, const Population_t *population) {
+  char temporary[TUNE_PATH_SIZE];
+  int features = FEATURES_COUNT;
+  bool isValid = snprintf(temporary, sizeof(temporary), "%s.tmp", path) <
+                 (int)sizeof(temporary);
+  FILE *file = isValid ? fopen(temporary, "wb") : NULL;
+
+  isValid =
+      file &&
+      fwrite(TUNE_MAGIC, 1, TUNE_MAGIC_SIZE, file) == TUNE_MAGIC_SIZE &&
+      fwrite(&features, sizeof(features), 1, file) == 1 &&
+      fwrite(&population->count, sizeof(population->count), 1, file) == 1 &&
+      fwrite(&population->generation, sizeof(population->generation), 1,
+             file) == 1 &&
+      fwrite(&population->random, sizeof(population->random), 1, file) == 1;
+
+  for (int i = 0; isValid && i < population->count; ++i) {
+    isValid = fwrite(population->candidates[i].values, sizeof(float),
+                     FEATURES_COUNT, file) == FEATURES_COUNT;
+  }
+
+  if (file && fclose(file) != 0) isValid = false;
+
+  return isValid && rename(temporary, path) == 0;
+}
+
+unsigned long playTuneGame(const Weights_t *weights, unsigned int seed,
+                           unsigned long pieces) {
+  Board_t board;
+  unsigned long lines = 0;
+  bool isOver = false;
+  int type = (int)(getRandom(&seed) % FIGURES_COUNT);
+
+  resetBoard(&board);
+
+  for (unsigned long k = 0; k < pieces && !isOver; ++k) {
+    int typeNext = (int)(getRandom(&seed) % FIGURES_COUNT);
+    Figure_t figure;
+    Placement_t placement;
+
+    // Deadline 0 leaves placement to evaluation of weights only
+    isOver = !spawnBoardFigure(&board, type, &figure) ||
+             !choosePlacement(&board, &figure, typeNext, weights, 0,
+                              &placement);
+
+    if (!isOver) {
+      lines += (unsigned long)placePiece(
+          &board, getPiece(type, placement.rotation), placement.x,
+          placement.y);
+    }
+
+    type = typeNext;
+  }
+
+  return lines;
+}
+
+uint64_t getTuneKey(const Weights_t *weights, unsigned int seed) {
+  uint64_t key = (uint64_t)seed + 1;
+
+  for (int i = 0; i < FEATURES_COUNT; ++i) {
+    uint32_t bits;
+    memcpy(&bits, &weights->values[i], sizeof(bits));
+    key = (key ^ bits) * 0x9E3779B97F4A7C15ull;
+    key ^= key >> 29;
+  }
+
+  return key;
+}
+
+void evaluatePopulation(Tuner_t *tuner, int threadsCount) {
+  pthread_t threads[TUNE_THREADS_MAX];
+  Population_t *population = tuner->population;
+  int games = tuner->options->games;
+
+  atomic_store(&tuner->next, 0);
+
+  for (int i = 1; i < threadsCount; ++i) {
+    if (pthread_create(&threads[i], NULL, runTuneWorker, tuner) != 0) {
+      printf("\nUnable to start tuner...\n");
+      exit(1);
+    }
+  }
+
+  runTuneWorker(tuner);
+
+  for (int i = 1; i < threadsCount; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for (int i = 0; i < population->count; ++i) {
+    unsigned long lines = 0;
+    for (int j = 0; j < games; ++j) lines += tuner->lines[i][j];
+
+    population->fitness[i] = (double)lines / games;
+  }
+}
+
+void *runTuneWorker(void *arg) {
+  Tuner_t *tuner = arg;
+  const Population_t *population = tuner->population;
+  int games = tuner->options->games;
+  int jobs = population->count * games;
+  int job;
+
+  while ((job = atomic_fetch_add(&tuner->next, 1)) < jobs) {
+    const Weights_t *weights = &population->candidates[job / games];
+    unsigned int seed = tuner->options->seed + (unsigned int)(job % games);
+    uint64_t key = getTuneKey(weights, seed);
+    uint64_t data;
+
+    if (probeHash(&tuner->table, key, &data)) {
+      atomic_fetch_add(&tuner->cached, 1);
+    } else {
+      data = playTuneGame(weights, seed, tuner->options->pieces);
+      storeHash(&tuner->table, key, data);
+      atomic_fetch_add(&tuner->played, 1);
+    }
+
+    tuner->lines[job / games][job % games] = (unsigned long)data;
+  }
+
+  return NULL;
+}
+
+void sortPopulation(Population_t *population) {
+  for (int i = 1; i < population->count; ++i) {
+    Weights_t candidate = population->candidates[i];
+    double fitness = population->fitness[i];
+    int j = i;
+
+    for (; j > 0 && population->fitness[j - 1] < fitness; --j) {
+      population->candidates[j] = population->candidates[j - 1];
+      population->fitness[j] = population->fitness[j - 1];
+    }
+
+    population->candidates[j] = candidate;
+    population->fitness[j] = fitness;
+  }
+}
+
+void evolvePopulation(Population_t *population) {
+  Weights_t children[TUNE_POPULATION_MAX];
+  int elite = population->count / TUNE_ELITE;
+  if (elite < 1) elite = 1;
+
+  for (int i = elite; i < population->count; ++i) {
+    int a = selectParent(population);
+    int b = selectParent(population);
+    double sum = population->fitness[a] + population->fitness[b];
+    double share = sum > 0 ? population->fitness[a] / sum : 0.5;
+
+    for (int k = 0; k < FEATURES_COUNT; ++k) {
+      children[i].values[k] =
+          (float)(share * population->candidates[a].values[k] +
+                  (1 - share) * population->candidates[b].values[k]);
+    }
+
+    mutateWeights(&children[i], &population->random);
+  }
+
+  for (int i = elite; i < population->count; ++i) {
+    population->candidates[i] = children[i];
+    population->fitness[i] = 0;
+  }
+
+  population->generation++;
+}
+
+void runTune(const TuneOptions_t *options) {
+  bool isResumed = readCheckpoint(options->checkpointPath, &population);
+
+  if (!isResumed && access(options->checkpointPath, F_OK) == 0) {
+    printf("Error: Unable to read checkpoint (%s)\n", options->checkpointPath);
+    return;
+  }
+
+  if (isResumed) {
+    printf("resumed: generation %d, population %d\n", population.generation,
+           population.count);
+  } else {
+    initializePopulation(&population, options->population, options->seed);
+  }
+
+  int threadsCount = options->threads;
+  if (threadsCount < 1) threadsCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threadsCount < 1) threadsCount = 1;
+  if (threadsCount > TUNE_THREADS_MAX) threadsCount = TUNE_THREADS_MAX;
+
+  tuner.options = options;
+  tuner.population = &population;
+  atomic_init(&tuner.played, 0);
+  atomic_init(&tuner.cached, 0);
+  initializeHashTable(&tuner.table, TUNE_TABLE_BITS);
+
+  // Checkpoint holds population evolved after its last evaluation
+  evaluateGeneration(&tuner, threadsCount);
+  while (population.generation < options->generations) {
+    evolvePopulation(&population);
+    if (!writeCheckpoint(options->checkpointPath, &population)) {
+      printf("Error: Unable to write checkpoint (%s)\n",
+             options->checkpointPath);
+    }
+
+    evaluateGeneration(&tuner, threadsCount);
+  }
+
+  printf("best rows: %.1f\nweights:", population.fitness[0]);
+  for (int i = 0; i < FEATURES_COUNT; ++i) {
+    printf(" %.4f", population.candidates[0].values[i]);
+  }
+  printf("\n");
+
+  removeHashTable(&tuner.table);
+}
@@ -0,0 +1,222 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+/*****************************************************************************
+ * @file tetris_tune.h
+ * @brief Header File with Genetic Tuner of Evaluation Weights
+ *****************************************************************************/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "../brick_game/tetris/tetris_bot.h"
+#include "../brick_game/tetris/tetris_hash.h"
+
+#define TUNE_POPULATION 16
+#define TUNE_POPULATION_MAX 256
+#define TUNE_GENERATIONS 20
+#define TUNE_GAMES 4
+#define TUNE_GAMES_MAX 64
+#define TUNE_PIECES 1000
+#define TUNE_SEED 1
+#define TUNE_THREADS_MAX 64
+#define TUNE_TABLE_BITS 16
+#define TUNE_ELITE 4      // 1 / TUNE_ELITE of population survives as is
+#define TUNE_SIGMA 0.2f   // deviation of mutation of unit weights
+#define TUNE_MAGIC "TTUNE001"
+#define TUNE_MAGIC_SIZE 8
+#define TUNE_CHECKPOINT_PATH "./tune.ckpt"
+#define TUNE_PATH_SIZE 4096
+
+/*****************************************************************************
+ * @brief Tuner options struct
+ *
+ * @param population Number of candidates: [2..TUNE_POPULATION_MAX]
+ * @param generations Number of generations of the whole run
+ * @param games Number of seeded games of every candidate:
+ *[1..TUNE_GAMES_MAX]
+ * @param pieces Number of figures of every game
+ * @param threads Number of threads, 0 for number of online CPUs
+ * @param seed Seed of the first game and of evolution
+ * @param checkpointPath Path of checkpoint to resume from and to write
+ *****************************************************************************/
+typedef struct {
+  int population;
+  int generations;
+  int games;
+  unsigned long pieces;
+  int threads;
+  unsigned int seed;
+  const char *checkpointPath;
+} TuneOptions_t;
+
+/*****************************************************************************
+ * @brief Population struct
+ *
+ * Candidates are weights of unit length: evaluation picks the same
+ *placements for weights of any positive scale
+ *
+ * @param candidates Weights of candidates
+ * @param fitness Mean rows removed by candidates, kept sorted after
+ *sortPopulation
+ * @param count Number of candidates
+ * @param generation Number of generations evolved
+ * @param random State of random generator of evolution
+ *****************************************************************************/
+typedef struct {
+  Weights_t candidates[TUNE_POPULATION_MAX];
+  double fitness[TUNE_POPULATION_MAX];
+  int count;
+  int generation;
+  uint64_t random;
+} Population_t;
+
+/*****************************************************************************
+ * @brief Tuner struct
+ *
+ * Every game of every candidate is a job, threads take jobs by atomic index.
+ *Result of a game depends only on weights and seed, so it is kept in table
+ *and survivors of previous generations are not played again
+ *
+ * @param options Pointer to struct of TuneOptions_t
+ * @param population Population being evaluated
+ * @param table Rows removed by weights and seed
+ * @param lines Rows removed by every game of every candidate
+ * @param next Index of the next job
+ * @param played Number of games played
+ * @param cached Number of games taken from table
+ *****************************************************************************/
+typedef struct {
+  const TuneOptions_t *options;
+  Population_t *population;
+  HashTable_t table;
+  unsigned long lines[TUNE_POPULATION_MAX][TUNE_GAMES_MAX];
+  atomic_int next;
+  atomic_ulong played;
+  atomic_ulong cached;
+} Tuner_t;
+
+/*****************************************************************************
+ * @brief Parse command line options
+ *
+ * Parse [--population N] [--generations N] [--games N] [--pieces N]
+ *[--threads N] [--seed N] [--checkpoint PATH]
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Pointer to struct of TuneOptions_t to fill
+ * @return bool False if options are invalid
+ *****************************************************************************/
+bool parseTuneOptions(int argc, char *argv[], TuneOptions_t *options);
+
+/*****************************************************************************
+ * @brief Initialize population
+ *
+ * The first candidate is defaultWeights, others are its mutations
+ *
+ * @param population Pointer to struct of Population_t
+ * @param count Number of candidates
+ * @param seed Seed of evolution
+ *****************************************************************************/
+void initializePopulation(Population_t *population, int count,
+                          unsigned int seed);
+
+/*****************************************************************************
+ * @brief Read checkpoint
+ *
+ * @param path Path of checkpoint
+ * @param population Pointer to struct of Population_t to fill
+ * @return bool False if file can't be read or doesn't match build
+ *****************************************************************************/
+bool readCheckpoint(const char *path, Population_t *population);
+
+/*****************************************************************************
+ * @brief Write checkpoint
+ *
+ * Write candidates, generation and random state to temporary file and rename
+ *it over path, so a run killed while writing keeps the previous checkpoint
+ *
+ * @param path Path of checkpoint
+ * @param population Pointer to struct of Population_t
+ * @return bool False if file can't be written
+ *****************************************************************************/
+bool writeCheckpoint(const char *path, const Population_t *population);
+
+/*****************************************************************************
+ * @brief Play tuning game
+ *
+ * Bot places figures of seeded sequence by evaluation of weights without
+ *time budget, so result is deterministic
+ *
+ * @param weights Pointer to weights of evaluation
+ * @param seed Seed of figure sequence
+ * @param pieces Number of figures
+ * @return unsigned long Rows removed before game over or the last figure
+ *****************************************************************************/
+unsigned long playTuneGame(const Weights_t *weights, unsigned int seed,
+                           unsigned long pieces);
+
+/*****************************************************************************
+ * @brief Get key of game
+ *
+ * @param weights Pointer to weights of evaluation
+ * @param seed Seed of figure sequence
+ * @return uint64_t Hash of weights and seed
+ *****************************************************************************/
+uint64_t getTuneKey(const Weights_t *weights, unsigned int seed);
+
+/*****************************************************************************
+ * @brief Evaluate population
+ *
+ * Play games of every candidate on threads and set fitness
+ *
+ * @param tuner Pointer to struct of Tuner_t
+ * @param threadsCount Number of threads: [1..TUNE_THREADS_MAX]
+ *****************************************************************************/
+void evaluatePopulation(Tuner_t *tuner, int threadsCount);
+
+/*****************************************************************************
+ * @brief Tuner thread loop
+ *
+ * Thread routine: take jobs until none is left
+ *
+ * @param arg Pointer to struct of Tuner_t
+ * @return void* Always NULL
+ *****************************************************************************/
+void *runTuneWorker(void *arg);
+
+/*****************************************************************************
+ * @brief Sort population
+ *
+ * Order candidates by fitness, the best first
+ *
+ * @param population Pointer to struct of Population_t
+ *****************************************************************************/
+void sortPopulation(Population_t *population);
+
+/*****************************************************************************
+ * @brief Evolve population
+ *
+ * Keep the best candidates and replace others with children of tournament
+ *winners: fitness weighted mean of parents with one mutated weight
+ *
+ * @param population Pointer to sorted struct of Population_t
+ *****************************************************************************/
+void evolvePopulation(Population_t *population);
+
+/*****************************************************************************
+ * @brief Run tuner
+ *
+ * Resume from checkpoint or start new population, evaluate and evolve it
+ *until the number of generations, print every generation and the best
+ *weights
+ *
+ * @param options Pointer to struct of TuneOptions_t
+ *****************************************************************************/
+void runTune(const TuneOptions_t *options);
+
+#endif  // TUNE_H